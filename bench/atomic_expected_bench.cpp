@@ -0,0 +1,84 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "atomic_expected.h"
+#include "bench.h"
+
+// One writer publishing results while three readers poll them: atomic_expected (lock-free for
+// expected<uint32_t, uint16_t>, a seqlock for a 24-byte value) against the same expected behind
+// a std::mutex. Prints the writer's time per store and how many loads the readers got done.
+using small = gb::expected<std::uint32_t, std::uint16_t>;
+using large = gb::expected<std::array<std::uint64_t, 3>, std::uint16_t>;
+
+template <class T>
+struct locked
+{
+    T load()
+    {
+        std::lock_guard lock(m_mutex);
+        return m_value;
+    }
+
+    void store(const T &v)
+    {
+        std::lock_guard lock(m_mutex);
+        m_value = v;
+    }
+
+    std::mutex m_mutex;
+    T m_value;
+};
+
+template <class Cell, class T, class Make>
+static void contend(const char *name, Make make)
+{
+    constexpr std::size_t stores = 1'000'000;
+    Cell cell;
+    cell.store(make(0));
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> loads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&] {
+            std::uint64_t n = 0;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                T v = cell.load();
+                gb_bench::keep(v);
+                ++n;
+            }
+            loads += n;
+        });
+    }
+    gb_bench::run(name, stores, [&](std::size_t i) { cell.store(make(i)); });
+    done = true;
+    for (auto &t : readers)
+    {
+        t.join();
+    }
+    std::printf("%-48s %10llu loads\n", "", static_cast<unsigned long long>(loads.load()));
+}
+
+int main()
+{
+    auto make_small = [](std::size_t i) {
+        return i % 8 ? small(std::in_place, static_cast<std::uint32_t>(i)) : small(gb::unexpect, std::uint16_t{1});
+    };
+    auto make_large = [](std::size_t i) {
+        return i % 8 ? large(std::in_place, std::array<std::uint64_t, 3>{i, i, i}) : large(gb::unexpect, std::uint16_t{1});
+    };
+    static_assert(gb::atomic_expected<std::uint32_t, std::uint16_t>::is_always_lock_free);
+
+    contend<gb::atomic_expected<std::uint32_t, std::uint16_t>, small>("atomic_expected, 8 bytes, lock-free (store)",
+                                                                      make_small);
+    contend<locked<small>, small>("std::mutex, 8 bytes (store)", make_small);
+    contend<gb::atomic_expected<std::array<std::uint64_t, 3>, std::uint16_t>, large>(
+        "atomic_expected, 32 bytes, seqlock (store)", make_large);
+    contend<locked<large>, large>("std::mutex, 32 bytes (store)", make_large);
+}
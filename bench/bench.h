@@ -0,0 +1,34 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+// Minimal timing harness for the programs under bench/. Each program times a few loops and prints
+// the average time per iteration; build them with the default -O2 (not the Debug build, which
+// adds sanitizers) and compare numbers from the same machine only.
+namespace gb_bench {
+
+// keeps value, and everything it was computed from, from being optimized away
+template <class T>
+inline void keep(T &value)
+{
+    asm volatile("" : "+m"(value) : : "memory");
+}
+
+// runs f(i) for i in [0, n) after one warm-up call and prints the time per call in ns
+template <class F>
+double run(const char *name, std::size_t n, F &&f)
+{
+    f(std::size_t{0});
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        f(i);
+    }
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    const double ns = elapsed.count() / static_cast<double>(n);
+    std::printf("%-48s %10.2f ns\n", name, ns);
+    return ns;
+}
+
+} // namespace gb_bench
@@ -0,0 +1,108 @@
+#include <cstdlib>
+#include <new>
+
+#include "bench.h"
+#include "expected_coroutine.h"
+
+// Three levels of expected-returning calls written as coroutines that co_await each other,
+// against the same calls with handwritten early returns. Counts the heap allocations too.
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n)
+{
+    ++allocations;
+    if (void *p = std::malloc(n))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+using result = gb::expected<int, int>;
+
+[[gnu::noinline]] static result leaf(int v)
+{
+    if (v < 0)
+    {
+        return result(gb::unexpect, v);
+    }
+    return result(std::in_place, v + 1);
+}
+
+static result co_mid(int v)
+{
+    int a = co_await leaf(v);
+    int b = co_await leaf(a);
+    co_return a + b;
+}
+
+static result co_top(int v)
+{
+    int a = co_await co_mid(v);
+    int b = co_await co_mid(v - 1);
+    co_return a * b;
+}
+
+static result mid(int v)
+{
+    auto a = leaf(v);
+    if (!a)
+    {
+        return result(gb::unexpect, a.error());
+    }
+    auto b = leaf(*a);
+    if (!b)
+    {
+        return result(gb::unexpect, b.error());
+    }
+    return result(std::in_place, *a + *b);
+}
+
+static result top(int v)
+{
+    auto a = mid(v);
+    if (!a)
+    {
+        return result(gb::unexpect, a.error());
+    }
+    auto b = mid(v - 1);
+    if (!b)
+    {
+        return result(gb::unexpect, b.error());
+    }
+    return result(std::in_place, *a * *b);
+}
+
+int main()
+{
+    constexpr std::size_t n = 10'000'000;
+    long sum = 0;
+
+    // every 16th call fails in the first leaf
+    auto input = [](std::size_t i) { return (i & 15) == 0 ? -1 : static_cast<int>(i & 1023); };
+
+    gb_bench::run("handwritten early returns", n, [&](std::size_t i) {
+        auto r = top(input(i));
+        sum += r ? *r : r.error();
+        gb_bench::keep(sum);
+    });
+
+    co_top(1); // the thread's frame stack is allocated once
+    const std::size_t before = allocations;
+    gb_bench::run("coroutines with co_await", n, [&](std::size_t i) {
+        auto r = co_top(input(i));
+        sum += r ? *r : r.error();
+        gb_bench::keep(sum);
+    });
+    std::printf("heap allocations in the coroutine loop: %zu\n", allocations - before);
+}
@@ -0,0 +1,97 @@
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "bench.h"
+#include "error_arena.h"
+#include "expected.h"
+
+// Making a formatted error and adding one link of context to it, as arena_error inside a
+// per-request error_arena::scope and as a std::string message with a shared_ptr cause chain.
+// Counts heap allocations too.
+static std::size_t allocations = 0;
+
+void *operator new(std::size_t n)
+{
+    ++allocations;
+    if (void *p = std::malloc(n))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#define APP_ERRORS(X) X(bad_syntax, "syntax error")
+GB_DEFINE_ERROR_DOMAIN(app, 1, APP_ERRORS);
+
+[[gnu::noinline]] static gb::expected<int, gb::arena_error> parse(int line)
+{
+    return gb::unexpected<gb::arena_error>(gb::arena_error::format(app::bad_syntax, "line %d: unexpected '%c'", line, 'x'));
+}
+
+[[gnu::noinline]] static gb::expected<int, gb::arena_error> load(int line)
+{
+    return parse(line).transform_error([](gb::arena_error e) { return e.with_context("loading /etc/app/config.toml"); });
+}
+
+struct string_error
+{
+    std::string message;
+    std::shared_ptr<string_error> cause;
+};
+
+[[gnu::noinline]] static gb::expected<int, string_error> parse_string(int line)
+{
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "line %d: unexpected '%c'", line, 'x');
+    return gb::unexpected<string_error>(string_error{buffer, nullptr});
+}
+
+[[gnu::noinline]] static gb::expected<int, string_error> load_string(int line)
+{
+    return parse_string(line).transform_error([](string_error e) {
+        return string_error{"loading /etc/app/config.toml", std::make_shared<string_error>(std::move(e))};
+    });
+}
+
+int main()
+{
+    constexpr std::size_t requests = 10'000;
+    constexpr std::size_t errors_per_request = 300;
+    long sum = 0;
+
+    std::size_t before = allocations;
+    gb_bench::run("arena_error, scope of 300 (ns per request)", requests, [&](std::size_t i) {
+        gb::error_arena::scope s;
+        for (std::size_t j = 0; j < errors_per_request; ++j)
+        {
+            auto r = load(static_cast<int>(i + j));
+            sum += static_cast<long>(r.error().message_view().size());
+        }
+        gb_bench::keep(sum);
+    });
+    std::printf("%-48s %10zu allocations\n", "", allocations - before);
+
+    before = allocations;
+    gb_bench::run("string + shared_ptr cause, 300 (ns per request)", requests, [&](std::size_t i) {
+        for (std::size_t j = 0; j < errors_per_request; ++j)
+        {
+            auto r = load_string(static_cast<int>(i + j));
+            sum += static_cast<long>(r.error().message.size());
+        }
+        gb_bench::keep(sum);
+    });
+    std::printf("%-48s %10zu allocations\n", "", allocations - before);
+}
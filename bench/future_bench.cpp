@@ -0,0 +1,65 @@
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "expected_future.h"
+
+// Latency of a round trip between two threads through a pair of futures, with gb::future and
+// std::future (the pairs are made up front so only the hand-off is timed), and the cost of
+// making, setting and reading a pair on one thread.
+template <class Promise, class Future, class Get>
+static void ping_pong(const char *name, Get get)
+{
+    constexpr std::size_t trips = 100'000;
+    std::vector<Promise> ping(trips);
+    std::vector<Promise> pong(trips);
+    std::vector<Future> ping_f;
+    std::vector<Future> pong_f;
+    for (std::size_t i = 0; i < trips; ++i)
+    {
+        ping_f.push_back(ping[i].get_future());
+        pong_f.push_back(pong[i].get_future());
+    }
+
+    std::thread other([&] {
+        for (std::size_t i = 0; i < trips; ++i)
+        {
+            pong[i].set_value(get(ping_f[i]) + 1);
+        }
+    });
+    int v = 0;
+    std::size_t i = 0; // run() makes one more call than it is asked to, as a warm-up
+    gb_bench::run(name, trips - 2, [&](std::size_t) {
+        ping[i].set_value(v);
+        v = get(pong_f[i]);
+        ++i;
+    });
+    ping[trips - 1].set_value(v);
+    other.join();
+    gb_bench::keep(v);
+}
+
+int main()
+{
+    ping_pong<gb::promise<int, int>, gb::future<int, int>>("gb: round trip between two threads",
+                                                           [](gb::future<int, int> &f) { return *std::move(f).get(); });
+    ping_pong<std::promise<int>, std::future<int>>("std: round trip between two threads",
+                                                   [](std::future<int> &f) { return f.get(); });
+
+    long sum = 0;
+    gb_bench::run("gb: make, set, get on one thread", 1'000'000, [&](std::size_t i) {
+        gb::promise<int, int> p;
+        auto f = p.get_future();
+        p.set_value(static_cast<int>(i));
+        sum += *std::move(f).get();
+        gb_bench::keep(sum);
+    });
+    gb_bench::run("std: make, set, get on one thread", 1'000'000, [&](std::size_t i) {
+        std::promise<int> p;
+        auto f = p.get_future();
+        p.set_value(static_cast<int>(i));
+        sum += f.get();
+        gb_bench::keep(sum);
+    });
+}
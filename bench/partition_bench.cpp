@@ -0,0 +1,62 @@
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "bench.h"
+#include "expected_algorithms.h"
+
+// partition_results over 10M expected<int, int> with one error in 64, into preallocated spans
+// and through back_inserter, against a plain loop doing the same split by hand
+int main()
+{
+    constexpr std::size_t size = 10'000'000;
+    std::vector<gb::expected<int, int>> input;
+    input.reserve(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (i % 64 == 0)
+        {
+            input.emplace_back(gb::unexpect, static_cast<int>(i));
+        }
+        else
+        {
+            input.emplace_back(std::in_place, static_cast<int>(i));
+        }
+    }
+
+    std::vector<int> values(size);
+    std::vector<gb::indexed_error<int>> errors(size);
+    std::size_t kept = 0;
+
+    gb_bench::run("hand-written loop (ns per batch)", 10, [&](std::size_t) {
+        std::size_t nv = 0;
+        std::size_t ne = 0;
+        for (std::size_t i = 0; i < input.size(); ++i)
+        {
+            if (input[i])
+            {
+                values[nv++] = *input[i];
+            }
+            else
+            {
+                errors[ne++] = {i, input[i].error()};
+            }
+        }
+        kept += nv + ne;
+        gb_bench::keep(kept);
+    });
+    gb_bench::run("partition_results into spans (ns per batch)", 10, [&](std::size_t) {
+        auto r = gb::partition_results(input, std::span(values), std::span(errors));
+        kept += r.values.size() + r.errors.size();
+        gb_bench::keep(kept);
+    });
+    gb_bench::run("partition_results, back_inserter (ns per batch)", 10, [&](std::size_t) {
+        std::vector<int> v;
+        std::vector<gb::indexed_error<int>> e;
+        v.reserve(size);
+        e.reserve(size / 64 + 1);
+        gb::partition_results(input, std::back_inserter(v), std::back_inserter(e));
+        kept += v.size() + e.size();
+        gb_bench::keep(kept);
+    });
+}
@@ -0,0 +1,58 @@
+#include <string>
+
+#include "bench.h"
+#include "expected.h"
+#include "expected_pipeline.h"
+
+// A six-stage chain of transform()/and_then() against the same stages fused into a pipeline,
+// for a trivial value and for a std::string past the small string buffer. Both forms move the
+// value equally often, and the fused form only saves the intermediate has_value() tests.
+using text = gb::expected<std::string, int>;
+
+static text check(std::string s)
+{
+    if (s.empty())
+    {
+        return text(gb::unexpect, 1);
+    }
+    return text(std::in_place, std::move(s));
+}
+
+int main()
+{
+    constexpr std::size_t n = 10'000'000;
+    long sum = 0;
+
+    auto add = [](long v) { return v + 3; };
+    auto twice = [](long v) { return v * 2; };
+    gb_bench::run("eager, expected<long, int>, 6 x transform", n, [&](std::size_t i) {
+        gb::expected<long, int> e(std::in_place, static_cast<long>(i));
+        gb_bench::keep(e);
+        auto r = e.transform(add).transform(twice).transform(add).transform(twice).transform(add).transform(twice);
+        sum += *r;
+        gb_bench::keep(sum);
+    });
+    gb_bench::run("fused, expected<long, int>, 6 x map", n, [&](std::size_t i) {
+        gb::expected<long, int> e(std::in_place, static_cast<long>(i));
+        gb_bench::keep(e);
+        gb::expected<long, int> r =
+            e | gb::map(add) | gb::map(twice) | gb::map(add) | gb::map(twice) | gb::map(add) | gb::map(twice);
+        sum += *r;
+        gb_bench::keep(sum);
+    });
+
+    const std::string seed(48, 'a');
+    auto c = [](std::string s) { return check(std::move(s)); };
+    gb_bench::run("eager, expected<std::string, int>, 6 x and_then", n, [&](std::size_t) {
+        text e(std::in_place, seed);
+        auto r = std::move(e).and_then(c).and_then(c).and_then(c).and_then(c).and_then(c).and_then(c);
+        sum += (*r)[0];
+        gb_bench::keep(sum);
+    });
+    gb_bench::run("fused, expected<std::string, int>, 6 x then", n, [&](std::size_t) {
+        text e(std::in_place, seed);
+        text r = std::move(e) | gb::then(c) | gb::then(c) | gb::then(c) | gb::then(c) | gb::then(c) | gb::then(c);
+        sum += (*r)[0];
+        gb_bench::keep(sum);
+    });
+}
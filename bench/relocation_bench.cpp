@@ -0,0 +1,48 @@
+#include <memory>
+#include <vector>
+
+#include "bench.h"
+#include "expected.h"
+#include "result_vector.h"
+
+// Growing a buffer of expected<std::unique_ptr<job>, err> from empty with result_vector, which
+// relocates with memcpy, against std::vector, which move-constructs and destroys each element on
+// every reallocation. Only the growth is timed: the elements hold null pointers, so making and
+// destroying them is the same for both.
+struct job
+{
+    int id;
+};
+
+enum class err
+{
+    failed
+};
+
+using item = gb::expected<std::unique_ptr<job>, err>;
+
+template <class Vector>
+static void fill(const char *name, std::size_t size, std::size_t repeat)
+{
+    std::size_t kept = 0;
+    gb_bench::run(name, repeat, [&](std::size_t) {
+        Vector v;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            v.emplace_back(std::in_place, nullptr);
+        }
+        kept += v.size();
+        gb_bench::keep(kept);
+    });
+}
+
+int main()
+{
+    // 2M elements (32 MB) do not fit in the cache while growing; 20k do. The large fills go first:
+    // freeing their buffers raises glibc's mmap threshold, so the small ones are then served from
+    // the heap instead of fresh pages, and time the relocation rather than page faults
+    fill<std::vector<item>>("std::vector, grow to 2M (ns per fill)", 2'000'000, 10);
+    fill<gb::result_vector<item>>("gb::result_vector, grow to 2M (ns per fill)", 2'000'000, 10);
+    fill<std::vector<item>>("std::vector, grow to 20k (ns per fill)", 20'000, 1000);
+    fill<gb::result_vector<item>>("gb::result_vector, grow to 20k (ns per fill)", 20'000, 1000);
+}
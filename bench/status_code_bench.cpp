@@ -0,0 +1,52 @@
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include "bench.h"
+#include "expected.h"
+#include "status_code.h"
+
+// A failing call returning expected<int, E> whose error is then compared with a std::errc, for
+// E = erased_status_code and E = std::error_code, and the cost of getting the error's message
+[[gnu::noinline]] static gb::expected<int, gb::erased_status_code> open_status(int fail)
+{
+    if (fail)
+    {
+        return gb::unexpected<gb::erased_status_code>(gb::posix_code(ENOENT));
+    }
+    return 1;
+}
+
+[[gnu::noinline]] static gb::expected<int, std::error_code> open_error_code(int fail)
+{
+    if (fail)
+    {
+        return gb::unexpected<std::error_code>(std::error_code(ENOENT, std::system_category()));
+    }
+    return 1;
+}
+
+int main()
+{
+    long hits = 0;
+    gb_bench::run("erased_status_code: fail, compare with errc", 10'000'000, [&](std::size_t i) {
+        auto r = open_status(static_cast<int>(i | 1));
+        hits += r.error() == std::errc::no_such_file_or_directory;
+        gb_bench::keep(hits);
+    });
+    gb_bench::run("std::error_code: fail, compare with errc", 10'000'000, [&](std::size_t i) {
+        auto r = open_error_code(static_cast<int>(i | 1));
+        hits += r.error() == std::errc::no_such_file_or_directory;
+        gb_bench::keep(hits);
+    });
+    gb_bench::run("erased_status_code: message()", 1'000'000, [&](std::size_t i) {
+        auto r = open_status(static_cast<int>(i | 1));
+        hits += static_cast<long>(std::strlen(r.error().message()));
+        gb_bench::keep(hits);
+    });
+    gb_bench::run("std::error_code: message()", 1'000'000, [&](std::size_t i) {
+        auto r = open_error_code(static_cast<int>(i | 1));
+        hits += static_cast<long>(r.error().message().size());
+        gb_bench::keep(hits);
+    });
+}
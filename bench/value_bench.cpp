@@ -0,0 +1,77 @@
+#include <vector>
+
+#include "bench.h"
+#include "expected.h"
+
+// value() as it was before the throw moved to a cold helper: the allocation and the throw were
+// inlined into every caller
+template <class T, class E>
+inline const T &baseline_value(const gb::expected<T, E> &e)
+{
+    if (!e.has_value())
+        throw new gb::bad_expect_access<E>(e.error());
+    return *e;
+}
+
+// one call site of each, kept out of line so their code size can be compared:
+//   nm -S --size-sort value_bench | grep probe_
+[[gnu::noinline]] int probe_value(const gb::expected<int, int> &e)
+{
+    return e.value();
+}
+
+[[gnu::noinline]] int probe_baseline_value(const gb::expected<int, int> &e)
+{
+    return baseline_value(e);
+}
+
+// value() against the baseline, on the success path where the only difference is the code the
+// throw leaves inline, and on failure; operator* is the unchecked floor
+int main()
+{
+    std::vector<gb::expected<int, int>> values(1 << 16);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = static_cast<int>(i);
+    }
+    const std::size_t mask = values.size() - 1;
+
+    long sum = probe_value(values[1]) + probe_baseline_value(values[1]);
+    gb_bench::run("operator* (no check)", 100'000'000, [&](std::size_t i) {
+        sum += *values[i & mask];
+        gb_bench::keep(sum);
+    });
+    gb_bench::run("baseline value(), success path", 100'000'000, [&](std::size_t i) {
+        sum += baseline_value(values[i & mask]);
+        gb_bench::keep(sum);
+    });
+    gb_bench::run("value(), success path", 100'000'000, [&](std::size_t i) {
+        sum += values[i & mask].value();
+        gb_bench::keep(sum);
+    });
+
+    gb::expected<int, int> failed(gb::unexpect, 7);
+    gb_bench::run("baseline value(), failed: throw new", 200'000, [&](std::size_t) {
+        try
+        {
+            sum += baseline_value(failed);
+        }
+        catch (gb::bad_expect_access<int> *e)
+        {
+            delete e; // the old value() leaked it
+            ++sum;
+        }
+        gb_bench::keep(sum);
+    });
+    gb_bench::run("value(), failed: throw by value", 200'000, [&](std::size_t) {
+        try
+        {
+            sum += failed.value();
+        }
+        catch (const gb::bad_expect_access<void> &)
+        {
+            ++sum;
+        }
+        gb_bench::keep(sum);
+    });
+}
@@ -0,0 +1,64 @@
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "expected_when.h"
+
+// when_all and when_any over 10k futures: making the promises, combining them, settling every
+// input (on this thread, or from four threads) and reading the result, per batch
+static constexpr std::size_t inputs = 10'000;
+
+static void settle(std::vector<gb::promise<int, int>> &ps, unsigned threads)
+{
+    if (threads == 0)
+    {
+        for (std::size_t i = 0; i < ps.size(); ++i)
+        {
+            ps[i].set_value(static_cast<int>(i));
+        }
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&ps, t, threads] {
+            for (std::size_t i = t; i < ps.size(); i += threads)
+            {
+                ps[i].set_value(static_cast<int>(i));
+            }
+        });
+    }
+    for (auto &th : pool)
+    {
+        th.join();
+    }
+}
+
+template <class Combine>
+static void batch(const char *name, unsigned threads, Combine combine)
+{
+    std::size_t kept = 0;
+    gb_bench::run(name, 200, [&](std::size_t) {
+        std::vector<gb::promise<int, int>> ps(inputs);
+        std::vector<gb::future<int, int>> fs;
+        fs.reserve(inputs);
+        for (auto &p : ps)
+        {
+            fs.push_back(p.get_future());
+        }
+        auto all = combine(std::move(fs));
+        settle(ps, threads);
+        auto r = std::move(all).get();
+        kept += r.has_value();
+        gb_bench::keep(kept);
+    });
+}
+
+int main()
+{
+    auto all = [](std::vector<gb::future<int, int>> fs) { return gb::when_all(std::move(fs)); };
+    auto any = [](std::vector<gb::future<int, int>> fs) { return gb::when_any(std::move(fs)); };
+    batch("when_all of 10k, settled here (ns per batch)", 0, all);
+    batch("when_all of 10k, settled by 4 threads (ns per batch)", 4, all);
+    batch("when_any of 10k, settled here (ns per batch)", 0, any);
+}
@@ -0,0 +1,302 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "expected_type_traits.h"
+
+// Type-erased error for crossing library boundaries, without a heap allocation per failure:
+//
+//   gb::expected<page, gb::any_error> render(request r)
+//   {
+//       auto t = load_template(r.path).transform_error(gb::erase_error);  // expected<tmpl, any_error>
+//       ...
+//       return gb::unexpected<gb::any_error>(db_error{42, "deadlock"});
+//   }
+//
+//   if (auto *e = r.error().as<db_error>())
+//   {
+//       retry(e->code);
+//   }
+//
+// An error of up to any_error::inline_size bytes that moves without throwing is stored inside the
+// any_error; only larger ones are boxed on the heap. Dispatch goes through a constexpr table of
+// function pointers per stored type instead of a virtual base, so any copyable type can be stored
+// as is. expected<T, E> converts to expected<T, any_error> implicitly as well.
+namespace gb {
+
+class any_error;
+
+namespace detail {
+
+struct __any_error_vtable
+{
+    const void *type;
+    void (*copy)(void *dst, const void *src);
+    void (*move)(void *dst, void *src) noexcept; // move constructs dst and destroys src
+    void (*destroy)(void *p) noexcept;
+    const void *(*get)(const void *p) noexcept;
+    const char *(*message)(const void *p) noexcept;
+};
+
+// one per type, so its address identifies the type without RTTI; not const, so identical code
+// folding or constant merging cannot give two types the same address
+template <class E>
+inline char __any_error_tag;
+
+template <class E>
+inline constexpr bool __is_in_place_type = false;
+
+template <class E>
+inline constexpr bool __is_in_place_type<std::in_place_type_t<E>> = true;
+
+// an expected or unexpected is not taken for an error, so expected<T, G> converts to
+// expected<T, any_error> rather than being stored whole
+template <class E>
+concept __erasable_error = !std::is_same_v<E, any_error> && !is_expect_v<E> && !is_unexpect_v<E> &&
+                           !__is_in_place_type<E> && std::is_copy_constructible_v<E>;
+
+template <class E>
+const char *__any_error_message(const E &e) noexcept
+{
+    if constexpr (requires { { e.message() } -> std::convertible_to<const char *>; })
+    {
+        return e.message();
+    }
+    else if constexpr (requires { { e.what() } -> std::convertible_to<const char *>; })
+    {
+        return e.what();
+    }
+    else if constexpr (requires { { e.c_str() } -> std::convertible_to<const char *>; })
+    {
+        return e.c_str();
+    }
+    else if constexpr (std::is_convertible_v<const E &, const char *>)
+    {
+        return e;
+    }
+    else
+    {
+        return "unknown error";
+    }
+}
+
+template <class E>
+struct __any_error_inline
+{
+    static void copy(void *dst, const void *src)
+    {
+        ::new (dst) E(*static_cast<const E *>(src));
+    }
+
+    static void move(void *dst, void *src) noexcept
+    {
+        ::new (dst) E(std::move(*static_cast<E *>(src)));
+        static_cast<E *>(src)->~E();
+    }
+
+    static void destroy(void *p) noexcept
+    {
+        static_cast<E *>(p)->~E();
+    }
+
+    static const void *get(const void *p) noexcept
+    {
+        return p;
+    }
+
+    static const char *message(const void *p) noexcept
+    {
+        return __any_error_message(*static_cast<const E *>(p));
+    }
+
+    static constexpr __any_error_vtable table{&__any_error_tag<E>, &copy, &move, &destroy, &get, &message};
+};
+
+// the storage holds an E *
+template <class E>
+struct __any_error_boxed
+{
+    static void copy(void *dst, const void *src)
+    {
+        ::new (dst) E *(new E(**static_cast<E *const *>(src)));
+    }
+
+    static void move(void *dst, void *src) noexcept
+    {
+        ::new (dst) E *(*static_cast<E **>(src));
+    }
+
+    static void destroy(void *p) noexcept
+    {
+        delete *static_cast<E **>(p);
+    }
+
+    static const void *get(const void *p) noexcept
+    {
+        return *static_cast<E *const *>(p);
+    }
+
+    static const char *message(const void *p) noexcept
+    {
+        return __any_error_message(**static_cast<E *const *>(p));
+    }
+
+    static constexpr __any_error_vtable table{&__any_error_tag<E>, &copy, &move, &destroy, &get, &message};
+};
+
+} // namespace detail
+
+class any_error
+{
+public:
+    static constexpr std::size_t inline_size = 48;
+
+    template <class E>
+    static constexpr bool stores_inline = sizeof(E) <= inline_size && alignof(E) <= alignof(std::max_align_t) &&
+                                          std::is_nothrow_move_constructible_v<E>;
+
+    // holds no error; only an empty any_error is left behind by a move
+    any_error() noexcept = default;
+
+    template <class E>
+        requires detail::__erasable_error<std::decay_t<E>> && std::is_constructible_v<std::decay_t<E>, E>
+    any_error(E &&e)
+        : any_error(std::in_place_type<std::decay_t<E>>, std::forward<E>(e))
+    {
+    }
+
+    template <class E, class... Args>
+        requires std::is_copy_constructible_v<E> && std::is_constructible_v<E, Args...>
+    explicit any_error(std::in_place_type_t<E>, Args &&...args)
+    {
+        if constexpr (stores_inline<E>)
+        {
+            ::new (static_cast<void *>(m_storage)) E(std::forward<Args>(args)...);
+            m_vtable = &detail::__any_error_inline<E>::table;
+        }
+        else
+        {
+            ::new (static_cast<void *>(m_storage)) E *(new E(std::forward<Args>(args)...));
+            m_vtable = &detail::__any_error_boxed<E>::table;
+        }
+    }
+
+    any_error(const any_error &other)
+        : m_vtable(other.m_vtable)
+    {
+        if (m_vtable)
+        {
+            m_vtable->copy(m_storage, other.m_storage);
+        }
+    }
+
+    any_error(any_error &&other) noexcept
+        : m_vtable(std::exchange(other.m_vtable, nullptr))
+    {
+        if (m_vtable)
+        {
+            m_vtable->move(m_storage, other.m_storage);
+        }
+    }
+
+    any_error &operator=(const any_error &other)
+    {
+        if (this != std::addressof(other))
+        {
+            any_error __tmp(other);
+            swap(__tmp);
+        }
+        return *this;
+    }
+
+    any_error &operator=(any_error &&other) noexcept
+    {
+        any_error __tmp(std::move(other));
+        swap(__tmp);
+        return *this;
+    }
+
+    ~any_error()
+    {
+        if (m_vtable)
+        {
+            m_vtable->destroy(m_storage);
+        }
+    }
+
+    void swap(any_error &other) noexcept
+    {
+        any_error __tmp;
+        __tmp.__take(*this);
+        __take(other);
+        other.__take(__tmp);
+    }
+
+    friend void swap(any_error &x, any_error &y) noexcept
+    {
+        x.swap(y);
+    }
+
+    bool empty() const noexcept { return m_vtable == nullptr; }
+
+    template <class E>
+    bool is() const noexcept
+    {
+        return m_vtable && m_vtable->type == &detail::__any_error_tag<E>;
+    }
+
+    // the stored error if it is an E, else nullptr
+    template <class E>
+    const E *as() const noexcept
+    {
+        return is<E>() ? static_cast<const E *>(m_vtable->get(m_storage)) : nullptr;
+    }
+
+    template <class E>
+    E *as() noexcept
+    {
+        return const_cast<E *>(std::as_const(*this).as<E>());
+    }
+
+    // E's message(), what() or c_str(), whichever it has
+    const char *message() const noexcept
+    {
+        return m_vtable ? m_vtable->message(m_storage) : "no error";
+    }
+
+private:
+    // requires empty()
+    void __take(any_error &other) noexcept
+    {
+        m_vtable = std::exchange(other.m_vtable, nullptr);
+        if (m_vtable)
+        {
+            m_vtable->move(m_storage, other.m_storage);
+        }
+    }
+
+    alignas(std::max_align_t) std::byte m_storage[inline_size];
+    const detail::__any_error_vtable *m_vtable = nullptr;
+};
+
+namespace detail {
+
+struct __erase_error_fn
+{
+    template <class E>
+    any_error operator()(E &&e) const
+    {
+        return any_error(std::forward<E>(e));
+    }
+};
+
+} // namespace detail
+
+// for transform_error: expected<T, E> -> expected<T, any_error>
+inline constexpr detail::__erase_error_fn erase_error{};
+
+} // namespace gb
@@ -0,0 +1,457 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "expected.h"
+
+namespace gb {
+namespace detail {
+
+template <class T>
+struct __payload_size : std::integral_constant<std::size_t, sizeof(T)>
+{
+};
+
+template <>
+struct __payload_size<void> : std::integral_constant<std::size_t, 0>
+{
+};
+
+template <class T>
+inline constexpr bool __unique_or_void = std::is_void_v<T> || std::has_unique_object_representations_v<T>;
+
+template <class T>
+inline constexpr bool __trivial_or_void = std::is_void_v<T> || std::is_trivially_copyable_v<T>;
+
+// Canonical image of an expected: the active payload's bytes followed by one tag byte, unused
+// bytes zero. Two images are equal exactly when the expected values are, as long as the
+// payloads have unique object representations.
+template <class T, class E>
+struct __expected_image
+{
+    static constexpr std::size_t payload = std::max(__payload_size<T>::value, __payload_size<E>::value);
+    static constexpr std::size_t size = payload + 1;
+
+    using bytes = std::array<unsigned char, size>;
+
+    template <class U>
+    static void __put(bytes &b, const U &u) noexcept
+    {
+        const auto __src = std::bit_cast<std::array<unsigned char, sizeof(U)>>(u);
+        for (std::size_t __i = 0; __i < sizeof(U); ++__i)
+        {
+            b[__i] = __src[__i];
+        }
+    }
+
+    template <class U>
+    static U __get(const bytes &b) noexcept
+    {
+        std::array<unsigned char, sizeof(U)> __dst;
+        for (std::size_t __i = 0; __i < sizeof(U); ++__i)
+        {
+            __dst[__i] = b[__i];
+        }
+        return std::bit_cast<U>(__dst);
+    }
+
+    static bytes pack(const expected<T, E> &e) noexcept
+    {
+        bytes __b{};
+        if (e.has_value())
+        {
+            __b[payload] = 1;
+            if constexpr (!std::is_void_v<T>)
+            {
+                __put(__b, *e);
+            }
+        }
+        else if constexpr (!std::is_void_v<E>)
+        {
+            __put(__b, e.error());
+        }
+        return __b;
+    }
+
+    static expected<T, E> unpack(const bytes &b) noexcept
+    {
+        if (b[payload])
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                return expected<T, E>(expect);
+            }
+            else
+            {
+                return expected<T, E>(std::in_place, __get<T>(b));
+            }
+        }
+        if constexpr (std::is_void_v<E>)
+        {
+            return expected<T, E>(unexpect);
+        }
+        else
+        {
+            return expected<T, E>(unexpect, __get<E>(b));
+        }
+    }
+};
+
+// unsigned integer holding an image of n bytes, void if there is no lock-free one
+template <std::size_t N>
+struct __image_word
+{
+    using type = std::conditional_t<
+        N <= 1, std::uint8_t,
+        std::conditional_t<N <= 2, std::uint16_t,
+                           std::conditional_t<N <= 4, std::uint32_t, std::conditional_t<N <= 8, std::uint64_t, void>>>>;
+};
+
+template <class T, class E>
+concept __word_packable = __trivial_or_void<T> && __trivial_or_void<E> && __unique_or_void<T> && __unique_or_void<E> &&
+                          !std::is_void_v<typename __image_word<__expected_image<T, E>::size>::type> &&
+                          std::atomic<typename __image_word<__expected_image<T, E>::size>::type>::is_always_lock_free;
+
+// the image as an integer, byte i at bits [8i, 8i + 8)
+template <class T, class E>
+struct __word_codec
+{
+    using image = __expected_image<T, E>;
+    using word = typename __image_word<image::size>::type;
+
+    static word pack(const expected<T, E> &e) noexcept
+    {
+        const auto __b = image::pack(e);
+        word __w = 0;
+        for (std::size_t __i = 0; __i < image::size; ++__i)
+        {
+            __w |= static_cast<word>(static_cast<word>(__b[__i]) << (8 * __i));
+        }
+        return __w;
+    }
+
+    static expected<T, E> unpack(word w) noexcept
+    {
+        typename image::bytes __b;
+        for (std::size_t __i = 0; __i < image::size; ++__i)
+        {
+            __b[__i] = static_cast<unsigned char>(w >> (8 * __i));
+        }
+        return image::unpack(__b);
+    }
+};
+
+} // namespace detail
+
+// Atomic cell holding an expected<T, E>, the payloads being trivially copyable as for std::atomic.
+//
+// When the canonical image (payload plus a tag byte) fits a lock-free integer and the payloads
+// have unique object representations, every operation is a single atomic instruction on that
+// integer and compare_exchange compares values bitwise. Otherwise the cell is a seqlock: readers
+// retry instead of blocking, writers serialize on the sequence counter, and compare_exchange
+// compares with operator==. Both forms support wait/notify.
+template <class T, class E>
+class atomic_expected;
+
+template <class T, class E>
+    requires detail::__word_packable<T, E>
+class atomic_expected<T, E>
+{
+    using __codec = detail::__word_codec<T, E>;
+
+public:
+    using value_type = expected<T, E>;
+    static constexpr bool is_always_lock_free = true;
+
+    atomic_expected() noexcept
+        requires std::is_default_constructible_v<value_type>
+        : m_word(__codec::pack(value_type()))
+    {
+    }
+
+    atomic_expected(const value_type &desired) noexcept
+        : m_word(__codec::pack(desired))
+    {
+    }
+
+    atomic_expected(const atomic_expected &) = delete;
+    atomic_expected &operator=(const atomic_expected &) = delete;
+
+    bool is_lock_free() const noexcept { return true; }
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+        return __codec::unpack(m_word.load(order));
+    }
+
+    void store(const value_type &desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        m_word.store(__codec::pack(desired), order);
+    }
+
+    value_type exchange(const value_type &desired, std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return __codec::unpack(m_word.exchange(__codec::pack(desired), order));
+    }
+
+    bool compare_exchange_weak(value_type &exp, const value_type &desired, std::memory_order success,
+                               std::memory_order failure) noexcept
+    {
+        auto __old = __codec::pack(exp);
+        if (m_word.compare_exchange_weak(__old, __codec::pack(desired), success, failure))
+        {
+            return true;
+        }
+        exp = __codec::unpack(__old);
+        return false;
+    }
+
+    bool compare_exchange_strong(value_type &exp, const value_type &desired, std::memory_order success,
+                                 std::memory_order failure) noexcept
+    {
+        auto __old = __codec::pack(exp);
+        if (m_word.compare_exchange_strong(__old, __codec::pack(desired), success, failure))
+        {
+            return true;
+        }
+        exp = __codec::unpack(__old);
+        return false;
+    }
+
+    bool compare_exchange_weak(value_type &exp, const value_type &desired,
+                               std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return compare_exchange_weak(exp, desired, order, __failure_order(order));
+    }
+
+    bool compare_exchange_strong(value_type &exp, const value_type &desired,
+                                 std::memory_order order = std::memory_order_seq_cst) noexcept
+    {
+        return compare_exchange_strong(exp, desired, order, __failure_order(order));
+    }
+
+    // blocks while the cell holds old
+    void wait(const value_type &old, std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+        m_word.wait(__codec::pack(old), order);
+    }
+
+    void notify_one() noexcept { m_word.notify_one(); }
+    void notify_all() noexcept { m_word.notify_all(); }
+
+    operator value_type() const noexcept { return load(); }
+
+    value_type operator=(const value_type &desired) noexcept
+    {
+        store(desired);
+        return desired;
+    }
+
+private:
+    static constexpr std::memory_order __failure_order(std::memory_order order) noexcept
+    {
+        return order == std::memory_order_acq_rel   ? std::memory_order_acquire
+               : order == std::memory_order_release ? std::memory_order_relaxed
+                                                    : order;
+    }
+
+    std::atomic<typename __codec::word> m_word;
+};
+
+template <class T, class E>
+    requires(!detail::__word_packable<T, E>) && detail::__trivial_or_void<T> && detail::__trivial_or_void<E>
+class atomic_expected<T, E>
+{
+    using __image = detail::__expected_image<T, E>;
+    static constexpr std::size_t __word_count = (__image::size + 7) / 8;
+    using __words = std::array<std::uint64_t, __word_count>;
+
+public:
+    using value_type = expected<T, E>;
+    static constexpr bool is_always_lock_free = false;
+
+    atomic_expected() noexcept
+        requires std::is_default_constructible_v<value_type>
+        : atomic_expected(value_type())
+    {
+    }
+
+    atomic_expected(const value_type &desired) noexcept
+    {
+        __write(desired);
+    }
+
+    atomic_expected(const atomic_expected &) = delete;
+    atomic_expected &operator=(const atomic_expected &) = delete;
+
+    bool is_lock_free() const noexcept { return false; }
+
+    // the seqlock orders every operation, the memory_order arguments are accepted for
+    // interface compatibility
+    value_type load(std::memory_order = std::memory_order_seq_cst) const noexcept
+    {
+        return __read().first;
+    }
+
+    void store(const value_type &desired, std::memory_order = std::memory_order_seq_cst) noexcept
+    {
+        const auto __seq = __lock();
+        __write(desired);
+        __unlock(__seq);
+    }
+
+    value_type exchange(const value_type &desired, std::memory_order = std::memory_order_seq_cst) noexcept
+    {
+        const auto __seq = __lock();
+        value_type __old = __unpack(__load_words());
+        __write(desired);
+        __unlock(__seq);
+        return __old;
+    }
+
+    bool compare_exchange_strong(value_type &exp, const value_type &desired,
+                                 std::memory_order = std::memory_order_seq_cst,
+                                 std::memory_order = std::memory_order_seq_cst) noexcept
+    {
+        const auto __seq = __lock();
+        value_type __current = __unpack(__load_words());
+        if (__current == exp)
+        {
+            __write(desired);
+            __unlock(__seq);
+            return true;
+        }
+        __release(__seq);
+        exp = std::move(__current);
+        return false;
+    }
+
+    bool compare_exchange_weak(value_type &exp, const value_type &desired,
+                               std::memory_order success = std::memory_order_seq_cst,
+                               std::memory_order failure = std::memory_order_seq_cst) noexcept
+    {
+        return compare_exchange_strong(exp, desired, success, failure);
+    }
+
+    // blocks while the cell holds a value equal to old
+    void wait(const value_type &old, std::memory_order = std::memory_order_seq_cst) const noexcept
+    {
+        for (;;)
+        {
+            auto [__current, __seq] = __read();
+            if (!(__current == old))
+            {
+                return;
+            }
+            m_seq.wait(__seq, std::memory_order_acquire);
+        }
+    }
+
+    void notify_one() noexcept { m_seq.notify_one(); }
+    void notify_all() noexcept { m_seq.notify_all(); }
+
+    operator value_type() const noexcept { return load(); }
+
+    value_type operator=(const value_type &desired) noexcept
+    {
+        store(desired);
+        return desired;
+    }
+
+private:
+    // odd sequence numbers mark a write in progress; taking one is what serializes writers
+    std::uint64_t __lock() noexcept
+    {
+        std::uint64_t __seq = m_seq.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (__seq & 1)
+            {
+                m_seq.wait(__seq, std::memory_order_relaxed);
+                __seq = m_seq.load(std::memory_order_relaxed);
+            }
+            else if (m_seq.compare_exchange_weak(__seq, __seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                std::atomic_thread_fence(std::memory_order_release);
+                return __seq;
+            }
+        }
+    }
+
+    void __unlock(std::uint64_t seq) noexcept
+    {
+        m_seq.store(seq + 2, std::memory_order_release);
+        m_seq.notify_all();
+    }
+
+    // gives the lock back without publishing a change
+    void __release(std::uint64_t seq) noexcept
+    {
+        m_seq.store(seq, std::memory_order_release);
+        m_seq.notify_all();
+    }
+
+    std::pair<value_type, std::uint64_t> __read() const noexcept
+    {
+        for (;;)
+        {
+            const std::uint64_t __before = m_seq.load(std::memory_order_acquire);
+            if (__before & 1)
+            {
+                m_seq.wait(__before, std::memory_order_relaxed);
+                continue;
+            }
+            const __words __w = __load_words();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == __before)
+            {
+                return {__unpack(__w), __before};
+            }
+        }
+    }
+
+    __words __load_words() const noexcept
+    {
+        __words __w;
+        for (std::size_t __i = 0; __i < __word_count; ++__i)
+        {
+            __w[__i] = m_data[__i].load(std::memory_order_relaxed);
+        }
+        return __w;
+    }
+
+    void __write(const value_type &v) noexcept
+    {
+        const auto __b = __image::pack(v);
+        for (std::size_t __i = 0; __i < __word_count; ++__i)
+        {
+            std::uint64_t __w = 0;
+            for (std::size_t __j = 0; __j < 8 && __i * 8 + __j < __image::size; ++__j)
+            {
+                __w |= static_cast<std::uint64_t>(__b[__i * 8 + __j]) << (8 * __j);
+            }
+            m_data[__i].store(__w, std::memory_order_relaxed);
+        }
+    }
+
+    static value_type __unpack(const __words &w) noexcept
+    {
+        typename __image::bytes __b;
+        for (std::size_t __i = 0; __i < __image::size; ++__i)
+        {
+            __b[__i] = static_cast<unsigned char>(w[__i / 8] >> (8 * (__i % 8)));
+        }
+        return __image::unpack(__b);
+    }
+
+    mutable std::atomic<std::uint64_t> m_seq{0};
+    std::array<std::atomic<std::uint64_t>, __word_count> m_data{};
+};
+
+} // namespace gb
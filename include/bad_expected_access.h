@@ -1,5 +1,28 @@
 #pragma once
+#include <atomic>
+#include <cstdlib>
 #include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// What a failed value() does is chosen at compile time by defining GB_EXPECTED_FAILURE_POLICY to
+// one of the values below. Builds without exceptions default to terminate.
+#define GB_EXPECTED_POLICY_THROW 0
+#define GB_EXPECTED_POLICY_TERMINATE 1
+#define GB_EXPECTED_POLICY_TRAP 2
+
+#ifndef GB_EXPECTED_FAILURE_POLICY
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define GB_EXPECTED_FAILURE_POLICY GB_EXPECTED_POLICY_THROW
+#else
+#define GB_EXPECTED_FAILURE_POLICY GB_EXPECTED_POLICY_TERMINATE
+#endif
+#endif
+
+#if GB_EXPECTED_FAILURE_POLICY == GB_EXPECTED_POLICY_THROW && !(defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+#error "GB_EXPECTED_POLICY_THROW requires exceptions to be enabled"
+#endif
 
 namespace gb {
 
@@ -39,4 +62,71 @@ private:
   _Err __unex_;
 };
 
+// Called with the diagnostic message before std::terminate under GB_EXPECTED_POLICY_TERMINATE.
+using bad_expect_access_handler = void (*)(const char* __what) noexcept;
+
+namespace detail {
+inline std::atomic<bad_expect_access_handler> __bad_expect_access_handler{nullptr};
+}
+
+inline bad_expect_access_handler set_bad_expect_access_handler(bad_expect_access_handler __h) noexcept {
+  return detail::__bad_expect_access_handler.exchange(__h);
+}
+
+inline bad_expect_access_handler get_bad_expect_access_handler() noexcept {
+  return detail::__bad_expect_access_handler.load();
+}
+
+namespace detail {
+
+[[noreturn, gnu::cold, gnu::noinline]] inline void __abort_bad_expect_access() noexcept {
+#if GB_EXPECTED_FAILURE_POLICY == GB_EXPECTED_POLICY_TRAP
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_trap();
+#else
+  std::abort();
+#endif
+#else
+  if (auto __h = get_bad_expect_access_handler())
+    __h("bad access to expected");
+  std::terminate();
+#endif
 }
+
+// Failed value() calls end up here. Keeping the failure out of line and cold leaves only
+// a compare and a load on the inlined success path.
+template <class _Err>
+[[noreturn, gnu::cold, gnu::noinline]] void __fail_bad_expect_access([[maybe_unused]] _Err&& __e) {
+#if GB_EXPECTED_FAILURE_POLICY == GB_EXPECTED_POLICY_THROW
+  throw bad_expect_access<std::decay_t<_Err>>(std::forward<_Err>(__e));
+#else
+  __abort_bad_expect_access();
+#endif
+}
+
+[[noreturn, gnu::cold, gnu::noinline]] inline void __fail_bad_expect_access() {
+#if GB_EXPECTED_FAILURE_POLICY == GB_EXPECTED_POLICY_THROW
+  throw bad_expect_access<void>();
+#else
+  __abort_bad_expect_access();
+#endif
+}
+
+// A caller provided buffer that cannot take all of an algorithm's output. Follows the same policy
+// as a failed value(), throwing std::length_error under GB_EXPECTED_POLICY_THROW.
+[[noreturn, gnu::cold, gnu::noinline]] inline void __fail_length(const char* __what) {
+#if GB_EXPECTED_FAILURE_POLICY == GB_EXPECTED_POLICY_THROW
+  throw std::length_error(__what);
+#elif GB_EXPECTED_FAILURE_POLICY == GB_EXPECTED_POLICY_TRAP
+  (void)__what;
+  __abort_bad_expect_access();
+#else
+  if (auto __h = get_bad_expect_access_handler())
+    __h(__what);
+  std::terminate();
+#endif
+}
+
+}
+
+}
\ No newline at end of file
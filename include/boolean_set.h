@@ -0,0 +1,198 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <span>
+
+#include "expected.h"
+#include "expected_bitmap.h"
+
+namespace gb {
+
+// Bit packed batch of boolean (expected<void, void>) outcomes: one bit per result instead of a
+// byte, with whole-word all/any/count and bitwise combination. Elements read as boolean and take
+// yes/no (or a bool) on assignment.
+class boolean_set
+{
+public:
+    using value_type = expected<void, void>;
+    using size_type = std::size_t;
+    using word_type = detail::bitmap::word_type;
+
+    class reference
+    {
+    public:
+        reference(detail::bitmap &bits, size_type i) noexcept
+            : m_bits(&bits), m_index(i)
+        {
+        }
+
+        bool has_value() const noexcept { return m_bits->test(m_index); }
+        explicit operator bool() const noexcept { return has_value(); }
+
+        operator value_type() const noexcept
+        {
+            return has_value() ? value_type(expect) : value_type(unexpect);
+        }
+
+        const reference &operator=(const value_type &b) const noexcept
+        {
+            m_bits->set(m_index, b.has_value());
+            return *this;
+        }
+
+        const reference &operator=(bool b) const noexcept
+        {
+            m_bits->set(m_index, b);
+            return *this;
+        }
+
+        const reference &operator=(const reference &other) const noexcept
+        {
+            return *this = other.has_value();
+        }
+
+    private:
+        detail::bitmap *m_bits;
+        size_type m_index;
+    };
+
+    // indices of the elements that are no, in increasing order
+    class failure_range
+    {
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using value_type = size_type;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+
+            iterator(const detail::bitmap &bits, size_type i) noexcept
+                : m_bits(&bits), m_index(i)
+            {
+            }
+
+            size_type operator*() const noexcept { return m_index; }
+
+            iterator &operator++() noexcept
+            {
+                m_index = m_bits->find_next(m_index + 1, false);
+                return *this;
+            }
+
+            iterator operator++(int) noexcept
+            {
+                auto __t = *this;
+                ++*this;
+                return __t;
+            }
+
+            friend bool operator==(const iterator &lhs, const iterator &rhs) noexcept
+            {
+                return lhs.m_index == rhs.m_index;
+            }
+
+        private:
+            const detail::bitmap *m_bits = nullptr;
+            size_type m_index = 0;
+        };
+
+        explicit failure_range(const detail::bitmap &bits) noexcept
+            : m_bits(&bits)
+        {
+        }
+
+        iterator begin() const noexcept { return {*m_bits, m_bits->find_next(0, false)}; }
+        iterator end() const noexcept { return {*m_bits, m_bits->size()}; }
+
+    private:
+        const detail::bitmap *m_bits;
+    };
+
+    boolean_set() = default;
+
+    explicit boolean_set(size_type n, const value_type &b = value_type(unexpect))
+        : m_bits(n, b.has_value())
+    {
+    }
+
+    size_type size() const noexcept { return m_bits.size(); }
+    bool empty() const noexcept { return m_bits.empty(); }
+
+    void reserve(size_type n) { m_bits.reserve(n); }
+    void clear() noexcept { m_bits.clear(); }
+    void resize(size_type n, const value_type &b = value_type(unexpect)) { m_bits.resize(n, b.has_value()); }
+
+    void push_back(const value_type &b) { m_bits.push_back(b.has_value()); }
+    void push_back(bool b) { m_bits.push_back(b); }
+    void pop_back() noexcept { m_bits.pop_back(); }
+
+    reference operator[](size_type i) noexcept { return {m_bits, i}; }
+
+    value_type operator[](size_type i) const noexcept
+    {
+        return m_bits.test(i) ? value_type(expect) : value_type(unexpect);
+    }
+
+    bool test(size_type i) const noexcept { return m_bits.test(i); }
+
+    // every element is yes; true for an empty set
+    bool all() const noexcept { return m_bits.all(); }
+    // some element is yes
+    bool any() const noexcept { return m_bits.any(); }
+    bool none() const noexcept { return m_bits.none(); }
+
+    // number of yes elements
+    size_type count() const noexcept { return m_bits.count(); }
+    size_type count_failed() const noexcept { return size() - count(); }
+
+    failure_range failures() const noexcept { return failure_range(m_bits); }
+
+    // first no at or after i, size() if there is none
+    size_type find_failure(size_type i = 0) const noexcept { return m_bits.find_next(i, false); }
+
+    // element-wise combination of two sets of the same size
+    boolean_set &operator&=(const boolean_set &other) noexcept
+    {
+        m_bits &= other.m_bits;
+        return *this;
+    }
+
+    boolean_set &operator|=(const boolean_set &other) noexcept
+    {
+        m_bits |= other.m_bits;
+        return *this;
+    }
+
+    boolean_set &operator^=(const boolean_set &other) noexcept
+    {
+        m_bits ^= other.m_bits;
+        return *this;
+    }
+
+    boolean_set &flip() noexcept
+    {
+        m_bits.flip();
+        return *this;
+    }
+
+    friend boolean_set operator&(boolean_set lhs, const boolean_set &rhs) noexcept { return lhs &= rhs; }
+    friend boolean_set operator|(boolean_set lhs, const boolean_set &rhs) noexcept { return lhs |= rhs; }
+    friend boolean_set operator^(boolean_set lhs, const boolean_set &rhs) noexcept { return lhs ^= rhs; }
+    friend boolean_set operator~(boolean_set s) noexcept { return s.flip(); }
+
+    friend bool operator==(const boolean_set &lhs, const boolean_set &rhs) noexcept
+    {
+        return lhs.m_bits == rhs.m_bits;
+    }
+
+    // the packed words, element i at bit i % 64 of word i / 64; bits past size() are zero
+    std::span<const word_type> words() const noexcept { return m_bits.words(); }
+
+private:
+    detail::bitmap m_bits;
+};
+
+} // namespace gb
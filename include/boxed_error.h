@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace gb {
+
+// Keeps a large error type out of line so that expected<T, boxed_error<E>> is sized by T
+// plus a pointer. The box converts to E& and is constructible from E, so error(), or_else
+// and transform_error callbacks written against E keep working; generic lambdas see the box
+// and reach the error through -> or *.
+template <class E>
+class boxed_error
+{
+public:
+    static_assert(!std::is_void_v<E> && !std::is_reference_v<E>, "E must be an object type");
+
+    boxed_error()
+        requires std::is_default_constructible_v<E>
+        : m_ptr(new E())
+    {
+    }
+
+    boxed_error(const E &e)
+        : m_ptr(new E(e))
+    {
+    }
+
+    boxed_error(E &&e)
+        : m_ptr(new E(std::move(e)))
+    {
+    }
+
+    template <class... Args>
+        requires std::is_constructible_v<E, Args...>
+    explicit boxed_error(std::in_place_t, Args &&...args)
+        : m_ptr(new E(std::forward<Args>(args)...))
+    {
+    }
+
+    boxed_error(const boxed_error &other)
+        : m_ptr(other.m_ptr ? new E(*other.m_ptr) : nullptr)
+    {
+    }
+
+    // leaves other empty: an empty box may be destroyed, assigned to, compared or tested with
+    // empty(), but get(), *, -> and the conversions to E require a box that is not empty
+    boxed_error(boxed_error &&other) noexcept
+        : m_ptr(std::exchange(other.m_ptr, nullptr))
+    {
+    }
+
+    boxed_error &operator=(const boxed_error &other)
+    {
+        if (this != std::addressof(other))
+        {
+            boxed_error __tmp(other);
+            swap(__tmp);
+        }
+        return *this;
+    }
+
+    boxed_error &operator=(boxed_error &&other) noexcept
+    {
+        boxed_error __tmp(std::move(other));
+        swap(__tmp);
+        return *this;
+    }
+
+    ~boxed_error()
+    {
+        delete m_ptr;
+    }
+
+    void swap(boxed_error &other) noexcept
+    {
+        std::swap(m_ptr, other.m_ptr);
+    }
+
+    friend void swap(boxed_error &x, boxed_error &y) noexcept
+    {
+        x.swap(y);
+    }
+
+    bool empty() const noexcept { return m_ptr == nullptr; }
+
+    E &get() & noexcept { return *m_ptr; }
+    const E &get() const & noexcept { return *m_ptr; }
+    E &&get() && noexcept { return std::move(*m_ptr); }
+    const E &&get() const && noexcept { return std::move(*m_ptr); }
+
+    E &operator*() & noexcept { return *m_ptr; }
+    const E &operator*() const & noexcept { return *m_ptr; }
+    E &&operator*() && noexcept { return std::move(*m_ptr); }
+    const E &&operator*() const && noexcept { return std::move(*m_ptr); }
+
+    E *operator->() noexcept { return m_ptr; }
+    const E *operator->() const noexcept { return m_ptr; }
+
+    operator E &() & noexcept { return *m_ptr; }
+    operator const E &() const & noexcept { return *m_ptr; }
+    operator E &&() && noexcept { return std::move(*m_ptr); }
+
+    // an empty box equals only another empty box
+    friend bool operator==(const boxed_error &lhs, const boxed_error &rhs)
+    {
+        if (!lhs.m_ptr || !rhs.m_ptr)
+        {
+            return lhs.m_ptr == rhs.m_ptr;
+        }
+        return *lhs.m_ptr == *rhs.m_ptr;
+    }
+
+    friend bool operator==(const boxed_error &lhs, const E &rhs)
+    {
+        return lhs.m_ptr && *lhs.m_ptr == rhs;
+    }
+
+private:
+    E *m_ptr;
+};
+
+// E itself while it is no bigger than Threshold, boxed_error<E> otherwise
+template <class E, std::size_t Threshold = 2 * sizeof(void *)>
+using boxed_if_large_t = std::conditional_t<(sizeof(E) > Threshold), boxed_error<E>, E>;
+
+} // namespace gb
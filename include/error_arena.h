@@ -0,0 +1,312 @@
+#pragma once
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <utility>
+
+#include "error_catalog.h"
+
+// Per-request memory for error payloads. arena_error is an error with context (a message, a code
+// from the catalog, and the error that caused it) that lives in a monotonic arena of the calling
+// thread instead of on the heap; it is a single pointer, so copying one copies the pointer:
+//
+//   gb::expected<config, gb::arena_error> load(std::string_view path)
+//   {
+//       auto text = read_file(path);
+//       if (!text)
+//       {
+//           return gb::unexpected<gb::arena_error>(gb::arena_error::format(io::not_found, "reading %s", path.data()));
+//       }
+//       return parse(*text).transform_error([&](gb::arena_error e) { return e.with_context("parsing config"); });
+//   }
+//
+//   void serve(request &r)
+//   {
+//       gb::error_arena::scope s;       // everything allocated below is released when s ends
+//       ...
+//   }
+//
+// Making an error or adding context is a bump of a pointer; the arena's chunks are kept when a
+// scope ends, so once they have grown to a request's needs, errors cost no heap allocation at all.
+// An arena_error must not outlive the scope it was made in, and belongs to the thread that made it
+// unless that thread waits for the other one. Errors made outside of any scope accumulate in the
+// thread's arena until error_arena::local().reset().
+namespace gb {
+
+class error_arena
+{
+    struct alignas(std::max_align_t) __chunk
+    {
+        __chunk *m_next;
+        std::size_t m_size;
+
+        char *begin() noexcept { return reinterpret_cast<char *>(this + 1); }
+        char *end() noexcept { return begin() + m_size; }
+    };
+
+public:
+    static constexpr std::size_t default_chunk_size = 4096;
+
+    // a position to rewind to
+    struct marker
+    {
+        __chunk *m_chunk;
+        char *m_ptr;
+    };
+
+    // makes the calling thread allocate errors from an arena, and rewinds it at the end
+    class scope
+    {
+    public:
+        scope() noexcept
+            : scope(current())
+        {
+        }
+
+        explicit scope(error_arena &arena) noexcept
+            : m_arena(arena), m_previous(std::exchange(__current, &arena)), m_mark(arena.mark())
+        {
+        }
+
+        scope(const scope &) = delete;
+        scope &operator=(const scope &) = delete;
+
+        ~scope()
+        {
+            m_arena.rewind(m_mark);
+            __current = m_previous;
+        }
+
+    private:
+        error_arena &m_arena;
+        error_arena *m_previous;
+        marker m_mark;
+    };
+
+    error_arena() noexcept = default;
+
+    explicit error_arena(std::size_t chunk_size) noexcept
+        : m_chunk_size(chunk_size)
+    {
+    }
+
+    error_arena(const error_arena &) = delete;
+    error_arena &operator=(const error_arena &) = delete;
+
+    ~error_arena()
+    {
+        for (__chunk *__c = m_head; __c;)
+        {
+            ::operator delete(std::exchange(__c, __c->m_next));
+        }
+    }
+
+    // the arena of the calling thread
+    static error_arena &local() noexcept
+    {
+        static thread_local error_arena __arena;
+        return __arena;
+    }
+
+    // the arena errors of the calling thread are allocated from: that of the innermost scope
+    static error_arena &current() noexcept
+    {
+        return __current ? *__current : local();
+    }
+
+    // align must be a power of two no larger than alignof(std::max_align_t)
+    void *allocate(std::size_t size, std::size_t align = alignof(std::max_align_t))
+    {
+        const auto __p = (reinterpret_cast<std::uintptr_t>(m_ptr) + align - 1) & ~(align - 1);
+        if (m_ptr && __p + size <= reinterpret_cast<std::uintptr_t>(m_end)) [[likely]]
+        {
+            m_ptr = reinterpret_cast<char *>(__p + size);
+            return reinterpret_cast<void *>(__p);
+        }
+        return __allocate_slow(size, align);
+    }
+
+    marker mark() const noexcept
+    {
+        return {m_current, m_ptr};
+    }
+
+    // releases everything allocated since m was taken
+    void rewind(marker m) noexcept
+    {
+        if (!m.m_chunk)
+        {
+            reset();
+            return;
+        }
+        m_current = m.m_chunk;
+        m_ptr = m.m_ptr;
+        m_end = m_current->end();
+    }
+
+    // releases everything; the chunks are kept for reuse
+    void reset() noexcept
+    {
+        m_current = m_head;
+        m_ptr = m_head ? m_head->begin() : nullptr;
+        m_end = m_head ? m_head->end() : nullptr;
+    }
+
+    // bytes held in chunks, used or not
+    std::size_t capacity() const noexcept
+    {
+        std::size_t __n = 0;
+        for (const __chunk *__c = m_head; __c; __c = __c->m_next)
+        {
+            __n += __c->m_size;
+        }
+        return __n;
+    }
+
+private:
+    // moves on to the next chunk, or puts a new one after the current chunk if that is too small
+    void *__allocate_slow(std::size_t size, std::size_t align)
+    {
+        const std::size_t __need = size + align;
+        __chunk *__next = m_current ? m_current->m_next : m_head;
+        if (!__next || __next->m_size < __need)
+        {
+            const std::size_t __bytes = std::max(__need, m_chunk_size);
+            auto *__c = static_cast<__chunk *>(::operator new(sizeof(__chunk) + __bytes));
+            __c->m_next = __next;
+            __c->m_size = __bytes;
+            (m_current ? m_current->m_next : m_head) = __c;
+            __next = __c;
+        }
+        m_current = __next;
+        m_ptr = __next->begin();
+        m_end = __next->end();
+        return allocate(size, align);
+    }
+
+    static inline constinit thread_local error_arena *__current = nullptr;
+
+    __chunk *m_head = nullptr;
+    __chunk *m_current = nullptr;
+    char *m_ptr = nullptr;
+    char *m_end = nullptr;
+    std::size_t m_chunk_size = default_chunk_size;
+};
+
+class arena_error
+{
+    struct __node
+    {
+        const __node *m_cause;
+        error_id m_code;
+        std::uint32_t m_size;
+
+        char *text() noexcept { return reinterpret_cast<char *>(this + 1); }
+        const char *text() const noexcept { return reinterpret_cast<const char *>(this + 1); }
+    };
+
+public:
+    // no error
+    arena_error() noexcept = default;
+
+    arena_error(error_id code, std::string_view message = {})
+        : m_node(__make(code, message, nullptr))
+    {
+    }
+
+    explicit arena_error(std::string_view message)
+        : arena_error(error_id(), message)
+    {
+    }
+
+    // the message printf-formatted; one that fits in 256 bytes is formatted once
+    static arena_error format(error_id code, const char *fmt, ...)
+    {
+        char __buffer[256];
+        std::va_list __args;
+        va_start(__args, fmt);
+        std::va_list __again;
+        va_copy(__again, __args);
+        const int __n = std::vsnprintf(__buffer, sizeof(__buffer), fmt, __args);
+        va_end(__args);
+
+        const std::size_t __size = __n > 0 ? static_cast<std::size_t>(__n) : 0;
+        __node *__e = __allocate(code, __size, nullptr);
+        if (__n < 0)
+        {
+            __e->text()[0] = '\0'; // a formatting error leaves the buffer unspecified: an empty message
+        }
+        else if (__size < sizeof(__buffer))
+        {
+            std::memcpy(__e->text(), __buffer, __size + 1);
+        }
+        else
+        {
+            std::vsnprintf(__e->text(), __size + 1, fmt, __again);
+        }
+        va_end(__again);
+        return arena_error(__e);
+    }
+
+    // an error caused by this one, with the same code
+    arena_error with_context(std::string_view message) const
+    {
+        return arena_error(__make(code(), message, m_node));
+    }
+
+    arena_error with_context(error_id code, std::string_view message) const
+    {
+        return arena_error(__make(code, message, m_node));
+    }
+
+    bool empty() const noexcept { return m_node == nullptr; }
+    error_id code() const noexcept { return m_node ? m_node->m_code : error_id(); }
+    const char *message() const noexcept { return m_node ? m_node->text() : ""; }
+    std::string_view message_view() const noexcept { return m_node ? std::string_view(m_node->text(), m_node->m_size) : std::string_view(); }
+
+    // the error this one was made from, or an empty one
+    arena_error cause() const noexcept { return arena_error(m_node ? m_node->m_cause : nullptr); }
+
+    // f(const arena_error &) for this error and then each of its causes
+    template <class F>
+    void for_each(F &&f) const
+    {
+        for (const __node *__n = m_node; __n; __n = __n->m_cause)
+        {
+            f(arena_error(__n));
+        }
+    }
+
+private:
+    explicit arena_error(const __node *node) noexcept
+        : m_node(node)
+    {
+    }
+
+    static __node *__allocate(error_id code, std::size_t size, const __node *cause)
+    {
+        void *__p = error_arena::current().allocate(sizeof(__node) + size + 1, alignof(__node));
+        return ::new (__p) __node{cause, code, static_cast<std::uint32_t>(size)};
+    }
+
+    static const __node *__make(error_id code, std::string_view message, const __node *cause)
+    {
+        __node *__e = __allocate(code, message.size(), cause);
+        char *__text = __e->text();
+        if (!message.empty())
+        {
+            std::memcpy(__text, message.data(), message.size());
+        }
+        __text[message.size()] = '\0';
+        return __e;
+    }
+
+    const __node *m_node = nullptr;
+};
+
+} // namespace gb
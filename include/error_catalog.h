@@ -0,0 +1,176 @@
+#pragma once
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+
+// Interned error catalog. A domain lists its errors once, with their messages, in an X-macro
+// (the severity is optional and defaults to error):
+//
+//   #define IO_ERRORS(X) X(not_found, "file not found") X(denied, "permission denied") X(corrupt, "bad checksum", fatal)
+//
+//   GB_DEFINE_ERROR_DOMAIN(io, 1, IO_ERRORS);     // at namespace scope, domain ids 1-255
+//
+// which defines `enum class io { not_found = 1, denied, corrupt }` and a constexpr table of
+// {name, message, severity} indexed by code. An enumerator converts to gb::error_id, a trivially
+// copyable 32-bit value (domain id in the top byte, code below) meant to be used as E:
+//
+//   gb::expected<file, gb::error_id> open(const char *path)
+//   {
+//       ...
+//       return gb::unexpected<gb::error_id>(io::not_found);
+//   }
+//
+//   if (!f)
+//   {
+//       log("%s: %s", f.error().domain_name(), f.error().message());
+//   }
+//
+// Making and passing an error never allocates, expected<T *, error_id> packs the error into the
+// pointer's niche (for a T that is niche_pointee), and message(), severity() and friends are two
+// indexed loads: the domain table is found through a 256 entry registry that each domain enters
+// when the program starts.
+namespace gb {
+
+enum class error_severity : std::uint8_t
+{
+    info,
+    warning,
+    error,
+    fatal
+};
+
+struct error_info
+{
+    const char *name; // the code as written in the catalog
+    const char *message;
+    error_severity severity = error_severity::error;
+};
+
+struct error_domain
+{
+    std::uint8_t id;
+    const char *name;
+    const error_info *table; // indexed by code; entry 0 stands for "no error"
+    std::uint32_t size;
+};
+
+namespace detail {
+
+inline constexpr error_info __no_error{"none", "no error", error_severity::info};
+inline constexpr error_info __unknown_error{"unknown", "unknown error", error_severity::error};
+
+inline constinit std::atomic<const error_domain *> __error_domains[256]{};
+
+// domains find each other through the __gb_error_domain overload GB_DEFINE_ERROR_DOMAIN declares
+template <class Enum>
+concept __catalog_enum = std::is_enum_v<Enum> && requires(Enum e) {
+    { __gb_error_domain(e) } -> std::same_as<const error_domain &>;
+};
+
+inline bool __register_error_domain(const error_domain &d) noexcept
+{
+    const error_domain *__previous = nullptr;
+    if (!__error_domains[d.id].compare_exchange_strong(__previous, &d, std::memory_order_acq_rel) && __previous != &d)
+    {
+        std::terminate(); // two domains were given the same id
+    }
+    return true;
+}
+
+} // namespace detail
+
+class error_id
+{
+public:
+    static constexpr std::uint32_t code_bits = 24;
+
+    // no error
+    constexpr error_id() noexcept = default;
+
+    template <detail::__catalog_enum Enum>
+    constexpr error_id(Enum code) noexcept
+        : m_value(std::uint32_t{__gb_error_domain(code).id} << code_bits | static_cast<std::uint32_t>(code))
+    {
+    }
+
+    static constexpr error_id from_raw(std::uint32_t raw) noexcept
+    {
+        error_id __e;
+        __e.m_value = raw;
+        return __e;
+    }
+
+    constexpr std::uint32_t raw() const noexcept { return m_value; }
+    constexpr std::uint8_t domain_id() const noexcept { return static_cast<std::uint8_t>(m_value >> code_bits); }
+    constexpr std::uint32_t code() const noexcept { return m_value & ((1u << code_bits) - 1); }
+
+    // true for an actual error
+    constexpr explicit operator bool() const noexcept { return m_value != 0; }
+
+    template <detail::__catalog_enum Enum>
+    constexpr bool is() const noexcept
+    {
+        return domain_id() == __gb_error_domain(Enum{}).id;
+    }
+
+    const error_info &info() const noexcept
+    {
+        if (!m_value)
+        {
+            return detail::__no_error;
+        }
+        const error_domain *__d = detail::__error_domains[domain_id()].load(std::memory_order_acquire);
+        return __d && code() < __d->size ? __d->table[code()] : detail::__unknown_error;
+    }
+
+    const char *name() const noexcept { return info().name; }
+    const char *message() const noexcept { return info().message; }
+    error_severity severity() const noexcept { return info().severity; }
+
+    const char *domain_name() const noexcept
+    {
+        const error_domain *__d = detail::__error_domains[domain_id()].load(std::memory_order_acquire);
+        return __d ? __d->name : "unknown";
+    }
+
+    friend constexpr bool operator==(error_id, error_id) noexcept = default;
+
+private:
+    std::uint32_t m_value = 0;
+};
+
+// the catalog entry of a code, at compile time
+template <detail::__catalog_enum Enum>
+constexpr const error_info &describe(Enum code) noexcept
+{
+    return __gb_error_domain(code).table[static_cast<std::uint32_t>(code)];
+}
+
+} // namespace gb
+
+#define GB_DETAIL_ERROR_ENUMERATOR(code, ...) code,
+#define GB_DETAIL_ERROR_INFO(code, message, ...)                                                                       \
+    ::gb::error_info{#code, message __VA_OPT__(, ::gb::error_severity::__VA_ARGS__)},
+
+#define GB_DEFINE_ERROR_DOMAIN(domain, domain_id, LIST)                                                                \
+    enum class domain : std::uint32_t                                                                                  \
+    {                                                                                                                  \
+        __none,                                                                                                        \
+        LIST(GB_DETAIL_ERROR_ENUMERATOR)                                                                               \
+    };                                                                                                                 \
+    inline constexpr ::gb::error_info __gb_error_table_##domain[] = {::gb::detail::__no_error,                        \
+                                                                      LIST(GB_DETAIL_ERROR_INFO)};                     \
+    static_assert((domain_id) > 0 && (domain_id) < 256, "error domain ids are 1-255");                                 \
+    static_assert(std::size(__gb_error_table_##domain) <= (1u << ::gb::error_id::code_bits));                          \
+    inline constexpr ::gb::error_domain __gb_error_domain_##domain{                                                    \
+        (domain_id), #domain, __gb_error_table_##domain,                                                               \
+        static_cast<std::uint32_t>(std::size(__gb_error_table_##domain))};                                             \
+    constexpr const ::gb::error_domain &__gb_error_domain(domain) noexcept                                             \
+    {                                                                                                                  \
+        return __gb_error_domain_##domain;                                                                             \
+    }                                                                                                                  \
+    inline const bool __gb_error_registered_##domain =                                                                 \
+        ::gb::detail::__register_error_domain(__gb_error_domain_##domain)
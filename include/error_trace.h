@@ -0,0 +1,140 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <source_location>
+#include <type_traits>
+
+// Error return trace. Building with GB_EXPECTED_ERROR_TRACE=1 makes every construction of an
+// unexpected or of an expected from unexpect, and every and_then/transform/or_else that meets an
+// error, append where it happened to a fixed-size ring of the calling thread: a source_location
+// (a pointer to static data) and a tick count, no allocation and no lock. The call site comes from
+// a defaulted source_location parameter on those functions (for expected(unexpect, args...), on
+// the conversion of the tag), so it is the line of user code that made the call.
+// dump_error_trace() prints the ring when an error surfaces:
+//
+//   if (!r)
+//   {
+//       gb::dump_error_trace(); // created at parse.cpp:41, propagated at load.cpp:88, ...
+//   }
+//
+// Without the macro the parameters and the recording compile to nothing.
+#ifndef GB_EXPECTED_ERROR_TRACE
+#define GB_EXPECTED_ERROR_TRACE 0
+#endif
+
+// entries kept per thread, a power of two
+#ifndef GB_EXPECTED_ERROR_TRACE_DEPTH
+#define GB_EXPECTED_ERROR_TRACE_DEPTH 64
+#endif
+
+// reading the TSC is the bulk of the cost of an entry, and some hypervisors trap it; 0 records
+// no ticks
+#ifndef GB_EXPECTED_ERROR_TRACE_TICKS
+#define GB_EXPECTED_ERROR_TRACE_TICKS 1
+#endif
+
+static_assert((GB_EXPECTED_ERROR_TRACE_DEPTH & (GB_EXPECTED_ERROR_TRACE_DEPTH - 1)) == 0,
+              "GB_EXPECTED_ERROR_TRACE_DEPTH must be a power of two");
+
+#if GB_EXPECTED_ERROR_TRACE
+#define GB_EXPECTED_TRACE_PARAM , ::std::source_location __trace_loc = ::std::source_location::current()
+#define GB_EXPECTED_TRACE_ARG , __trace_loc
+#define GB_EXPECTED_TRACE_AT(where, event)                                                                             \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!::std::is_constant_evaluated())                                                                           \
+        {                                                                                                              \
+            ::gb::detail::__record_error_trace(where, ::gb::error_trace_event::event);                                 \
+        }                                                                                                              \
+    } while (false)
+#else
+#define GB_EXPECTED_TRACE_PARAM
+#define GB_EXPECTED_TRACE_ARG
+#define GB_EXPECTED_TRACE_AT(where, event) ((void)0)
+#endif
+
+// records at the call site captured by GB_EXPECTED_TRACE_PARAM
+#define GB_EXPECTED_TRACE(event) GB_EXPECTED_TRACE_AT(__trace_loc, event)
+
+namespace gb {
+
+enum class error_trace_event : std::uint8_t
+{
+    created,    // an unexpected, or an expected from unexpect, was constructed
+    propagated, // and_then or transform passed an error on without calling f
+    handled     // or_else called f with an error
+};
+
+struct error_trace_entry
+{
+    std::source_location where;
+    std::uint64_t ticks; // a monotonic counter (the TSC on x86), only meaningful between entries
+    error_trace_event event;
+};
+
+namespace detail {
+
+struct __error_trace_ring
+{
+    static constexpr std::size_t depth = GB_EXPECTED_ERROR_TRACE_DEPTH;
+
+    std::array<error_trace_entry, depth> m_entries;
+    std::uint64_t m_count; // entries ever recorded; the next one goes to m_count % depth
+};
+
+// zero-initialized, so reaching it costs no initialization guard
+inline constinit thread_local __error_trace_ring __error_trace{};
+
+inline std::uint64_t __error_trace_ticks() noexcept
+{
+#if !GB_EXPECTED_ERROR_TRACE_TICKS
+    return 0;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+inline void __record_error_trace(const std::source_location &where, error_trace_event event) noexcept
+{
+    auto &__ring = __error_trace;
+    __ring.m_entries[__ring.m_count++ & (__error_trace_ring::depth - 1)] = {where, __error_trace_ticks(), event};
+}
+
+} // namespace detail
+
+// f(const error_trace_entry &) for the entries of the calling thread, oldest first
+template <class F>
+void for_each_error_trace(F &&f)
+{
+    const auto &__ring = detail::__error_trace;
+    constexpr std::size_t __depth = detail::__error_trace_ring::depth;
+    const std::uint64_t __first = __ring.m_count > __depth ? __ring.m_count - __depth : 0;
+    for (std::uint64_t __i = __first; __i < __ring.m_count; ++__i)
+    {
+        f(__ring.m_entries[__i & (__depth - 1)]);
+    }
+}
+
+inline void clear_error_trace() noexcept
+{
+    detail::__error_trace.m_count = 0;
+}
+
+inline void dump_error_trace(std::FILE *out = stderr)
+{
+    static constexpr const char *__names[] = {"created", "propagated", "handled"};
+    std::uint64_t __previous = 0;
+    for_each_error_trace([&](const error_trace_entry &e) {
+        std::fprintf(out, "  %-10s %s:%u in %s (+%llu ticks)\n", __names[static_cast<int>(e.event)], e.where.file_name(),
+                     static_cast<unsigned>(e.where.line()), e.where.function_name(),
+                     static_cast<unsigned long long>(__previous ? e.ticks - __previous : 0));
+        __previous = e.ticks;
+    });
+}
+
+} // namespace gb
@@ -1,11 +1,17 @@
+#pragma once
 #include "unexpected.h"
+#include "boxed_error.h"
 #include "expected_base.h"
 #include "expected_monadic_operations.h"
 #include "expected_value_error.h"
+#include "expected_value_error_niche.h"
 #include "expected_value_void.h"
+#include "expected_value_void_niche.h"
 #include "expected_void_error.h"
+#include "expected_void_error_niche.h"
 
 #include "expected_void_void.h"
+#include "expected_pipeline.h"
 
 template<class T>
 using optional = gb::expected<T, void>;
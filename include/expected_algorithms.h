@@ -0,0 +1,253 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "expected.h"
+
+namespace gb {
+namespace detail {
+
+template <class R>
+concept expected_range = std::ranges::input_range<R> && is_expect_v<std::ranges::range_value_t<R>>;
+
+template <class R>
+using range_expected_t = std::remove_cvref_t<std::ranges::range_value_t<R>>;
+
+// elements of an owning rvalue range (a vector passed by std::move) are moved from; those of an
+// lvalue range, of a view and of a borrowed range such as a span belong to the caller and are
+// copied
+template <class R>
+inline constexpr bool __moves_elements = !std::is_lvalue_reference_v<R> && !std::ranges::borrowed_range<R> &&
+                                         !std::ranges::view<std::remove_cvref_t<R>>;
+
+template <class R, class Ref>
+constexpr decltype(auto) __element(Ref &&e)
+{
+    if constexpr (!__moves_elements<R> || !std::is_lvalue_reference_v<Ref>)
+    {
+        return std::forward<Ref>(e);
+    }
+    else
+    {
+        return std::move(e);
+    }
+}
+
+template <class Result, class Exp>
+constexpr Result __propagate_error(Exp &&exp)
+{
+    if constexpr (std::is_void_v<expect_error_t<Result>>)
+    {
+        return Result(unexpect);
+    }
+    else
+    {
+        return Result(unexpect, std::forward<Exp>(exp).error());
+    }
+}
+
+} // namespace detail
+
+// All values of a range of expected, or its first error. Stops at the first error; sized ranges
+// are reserved up front. A range of expected<void, E> collects to expected<void, E>.
+template <detail::expected_range R>
+constexpr auto collect(R &&r)
+{
+    using exp_t = detail::range_expected_t<R>;
+    using value_t = expect_value_t<exp_t>;
+    using error_t = expect_error_t<exp_t>;
+
+    if constexpr (std::is_void_v<value_t>)
+    {
+        using result_t = expected<void, error_t>;
+        for (auto &&e : r)
+        {
+            if (!e.has_value())
+            {
+                return detail::__propagate_error<result_t>(detail::__element<R>(e));
+            }
+        }
+        return result_t(expect);
+    }
+    else
+    {
+        using result_t = expected<std::vector<value_t>, error_t>;
+        std::vector<value_t> __values;
+        if constexpr (std::ranges::sized_range<R>)
+        {
+            __values.reserve(std::ranges::size(r));
+        }
+        for (auto &&e : r)
+        {
+            if (!e.has_value())
+            {
+                return detail::__propagate_error<result_t>(detail::__element<R>(e));
+            }
+            __values.push_back(*detail::__element<R>(e));
+        }
+        return result_t(std::in_place, std::move(__values));
+    }
+}
+
+// Writes the values to out without allocating and returns the advanced iterator, or the first
+// error. Values before the error have already been written.
+template <detail::expected_range R, class O>
+    requires std::output_iterator<O, expect_value_t<detail::range_expected_t<R>>>
+constexpr auto collect_into(R &&r, O out)
+{
+    using error_t = expect_error_t<detail::range_expected_t<R>>;
+    using result_t = expected<O, error_t>;
+
+    for (auto &&e : r)
+    {
+        if (!e.has_value())
+        {
+            return detail::__propagate_error<result_t>(detail::__element<R>(e));
+        }
+        *out = *detail::__element<R>(e);
+        ++out;
+    }
+    return result_t(std::in_place, std::move(out));
+}
+
+// Same into a caller provided buffer, which must be at least as long as the range; returns the
+// written prefix of the buffer. A sized range is checked up front, any other one when the buffer
+// is full; a buffer that is too short fails like value() does (std::length_error by default) and is
+// never written past.
+template <detail::expected_range R, class T, std::size_t Extent>
+    requires std::is_assignable_v<T &, expect_value_t<detail::range_expected_t<R>>>
+constexpr auto collect_into(R &&r, std::span<T, Extent> out)
+{
+    using error_t = expect_error_t<detail::range_expected_t<R>>;
+    using result_t = expected<std::span<T>, error_t>;
+
+    if constexpr (std::ranges::sized_range<R>)
+    {
+        if (static_cast<std::size_t>(std::ranges::size(r)) > out.size())
+        {
+            detail::__fail_length("collect_into: the buffer is shorter than the range");
+        }
+    }
+    std::size_t __n = 0;
+    for (auto &&e : r)
+    {
+        if (!e.has_value())
+        {
+            return detail::__propagate_error<result_t>(detail::__element<R>(e));
+        }
+        if (__n == out.size())
+        {
+            detail::__fail_length("collect_into: the buffer is shorter than the range");
+        }
+        out[__n++] = *detail::__element<R>(e);
+    }
+    return result_t(std::in_place, out.first(__n));
+}
+
+// An error of a batch together with its position in the input
+template <class E>
+struct indexed_error
+{
+    std::size_t index;
+    E error;
+};
+
+template <>
+struct indexed_error<void>
+{
+    std::size_t index;
+};
+
+template <class V, class Err>
+struct partition_result
+{
+    V values;
+    Err errors;
+};
+
+namespace detail {
+
+template <class R, class Ref>
+constexpr auto __indexed_error(std::size_t i, Ref &&e)
+{
+    using error_t = expect_error_t<range_expected_t<R>>;
+    if constexpr (std::is_void_v<error_t>)
+    {
+        return indexed_error<void>{i};
+    }
+    else
+    {
+        return indexed_error<error_t>{i, __element<R>(e).error()};
+    }
+}
+
+} // namespace detail
+
+// Splits a batch in one pass: values go to values_out in input order, errors go to errors_out
+// as indexed_error<E> with their position in the input. Returns both advanced iterators.
+template <detail::expected_range R, class VO, class EO>
+    requires(!std::is_void_v<expect_value_t<detail::range_expected_t<R>>>) &&
+            std::output_iterator<VO, expect_value_t<detail::range_expected_t<R>>> &&
+            std::output_iterator<EO, indexed_error<expect_error_t<detail::range_expected_t<R>>>>
+constexpr partition_result<VO, EO> partition_results(R &&r, VO values_out, EO errors_out)
+{
+    std::size_t __i = 0;
+    for (auto &&e : r)
+    {
+        if (e.has_value())
+        {
+            *values_out = *detail::__element<R>(e);
+            ++values_out;
+        }
+        else
+        {
+            *errors_out = detail::__indexed_error<R>(__i, e);
+            ++errors_out;
+        }
+        ++__i;
+    }
+    return {std::move(values_out), std::move(errors_out)};
+}
+
+// Same into preallocated buffers, each of which must be able to hold every element it may
+// receive (at most the length of the range); returns the written prefixes. An element that does
+// not fit fails like value() does (std::length_error by default); neither buffer is written past.
+template <detail::expected_range R, class T, std::size_t VExtent, class IE, std::size_t EExtent>
+    requires(!std::is_void_v<expect_value_t<detail::range_expected_t<R>>>) &&
+            std::is_assignable_v<T &, expect_value_t<detail::range_expected_t<R>>> &&
+            std::is_assignable_v<IE &, indexed_error<expect_error_t<detail::range_expected_t<R>>>>
+constexpr partition_result<std::span<T>, std::span<IE>> partition_results(R &&r, std::span<T, VExtent> values,
+                                                                          std::span<IE, EExtent> errors)
+{
+    std::size_t __i = 0;
+    std::size_t __nv = 0;
+    std::size_t __ne = 0;
+    for (auto &&e : r)
+    {
+        if (e.has_value())
+        {
+            if (__nv == values.size())
+            {
+                detail::__fail_length("partition_results: more values than the value buffer holds");
+            }
+            values[__nv++] = *detail::__element<R>(e);
+        }
+        else
+        {
+            if (__ne == errors.size())
+            {
+                detail::__fail_length("partition_results: more errors than the error buffer holds");
+            }
+            errors[__ne++] = detail::__indexed_error<R>(__i, e);
+        }
+        ++__i;
+    }
+    return {values.first(__nv), errors.first(__ne)};
+}
+
+} // namespace gb
@@ -45,6 +45,20 @@ constexpr bool operator==(const expected<T, E>& lhs, const expected<U, F>& rhs)
     return false; //the types are not comparable 
 }
 
+template<class T, class E, class U, class F> //void T and U, non void E and F
+    requires std::is_void_v<T> && std::is_void_v<U> && (!std::is_void_v<E>) && (!std::is_void_v<F>)
+constexpr bool operator==(const expected<T, E>& lhs, const expected<U, F>& rhs)
+{
+    return (lhs.has_value() != rhs.has_value()) ? false : (!lhs.has_value() ? lhs.error() == rhs.error() : true);
+}
+
+template<class T, class E, class U, class F> //void E and F, non void T and U
+    requires std::is_void_v<E> && std::is_void_v<F> && (!std::is_void_v<T>) && (!std::is_void_v<U>)
+constexpr bool operator==(const expected<T, E>& lhs, const expected<U, F>& rhs)
+{
+    return (lhs.has_value() != rhs.has_value()) ? false : (!lhs.has_value() ? true : *lhs == *rhs);
+}
+
 template<class T, class E, class U, class F> //all void
     requires std::is_void_v<E> && std::is_void_v<F> && std::is_void_v<T> && std::is_void_v<U>
 constexpr bool operator==(const expected<T, E>& lhs, const expected<U, F>& rhs)
@@ -74,7 +88,7 @@ template<class T, class E, class U, class F> //void E or F but not both
     requires (std::is_void_v<E> || std::is_void_v<F>) && (!std::is_same_v<E, F>) && (!std::is_void_v<T>)&& (!std::is_void_v<U>)
 constexpr bool operator!=(const expected<T, E>& lhs, const expected<U, F>& rhs)
 {
-    return (lhs.has_value() != rhs.has_value()) ? true : (!lhs.has_value() ? true : *lhs == *rhs);
+    return (lhs.has_value() != rhs.has_value()) ? true : (!lhs.has_value() ? true : *lhs != *rhs);
 }
 
 template<class T, class E, class U, class F> //void E or F and void T or U
@@ -85,6 +99,20 @@ constexpr bool operator!=(const expected<T, E>& lhs, const expected<U, F>& rhs)
     return true; //the types are not comparable 
 }
 
+template<class T, class E, class U, class F> //void T and U, non void E and F
+    requires std::is_void_v<T> && std::is_void_v<U> && (!std::is_void_v<E>) && (!std::is_void_v<F>)
+constexpr bool operator!=(const expected<T, E>& lhs, const expected<U, F>& rhs)
+{
+    return (lhs.has_value() != rhs.has_value()) ? true : (!lhs.has_value() ? lhs.error() != rhs.error() : false);
+}
+
+template<class T, class E, class U, class F> //void E and F, non void T and U
+    requires std::is_void_v<E> && std::is_void_v<F> && (!std::is_void_v<T>) && (!std::is_void_v<U>)
+constexpr bool operator!=(const expected<T, E>& lhs, const expected<U, F>& rhs)
+{
+    return (lhs.has_value() != rhs.has_value()) ? true : (!lhs.has_value() ? false : *lhs != *rhs);
+}
+
 template<class T, class E, class U, class F> //all void
     requires std::is_void_v<E> && std::is_void_v<F> && std::is_void_v<T> && std::is_void_v<U>
 constexpr bool operator!=(const expected<T, E>& lhs, const expected<U, F>& rhs)
@@ -0,0 +1,236 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gb {
+namespace detail {
+
+// Growable bit vector packed into 64-bit words. Bits past size() in the last word are kept
+// cleared, so whole-word loops (count, any, bitwise ops) need no tail masking and stay simple
+// enough for the compiler to vectorize.
+class bitmap
+{
+public:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    bitmap() = default;
+
+    explicit bitmap(std::size_t n, bool value = false)
+        : m_words(__word_count(n), value ? ~word_type{0} : word_type{0}), m_size(n)
+    {
+        __clear_tail();
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    void reserve(std::size_t n) { m_words.reserve(__word_count(n)); }
+
+    void clear() noexcept
+    {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    void resize(std::size_t n, bool value = false)
+    {
+        const std::size_t __old = m_size;
+        m_words.resize(__word_count(n), value ? ~word_type{0} : word_type{0});
+        m_size = n;
+        if (value && n > __old && __old % word_bits)
+        {
+            m_words[__old / word_bits] |= ~word_type{0} << (__old % word_bits);
+        }
+        __clear_tail();
+    }
+
+    bool test(std::size_t i) const noexcept
+    {
+        return (m_words[i / word_bits] >> (i % word_bits)) & 1;
+    }
+
+    void set(std::size_t i) noexcept { m_words[i / word_bits] |= __bit(i); }
+    void reset(std::size_t i) noexcept { m_words[i / word_bits] &= ~__bit(i); }
+
+    void set(std::size_t i, bool value) noexcept
+    {
+        value ? set(i) : reset(i);
+    }
+
+    void push_back(bool value)
+    {
+        if (m_size % word_bits == 0)
+        {
+            m_words.push_back(0);
+        }
+        if (value)
+        {
+            m_words.back() |= __bit(m_size);
+        }
+        ++m_size;
+    }
+
+    void pop_back() noexcept
+    {
+        --m_size;
+        reset(m_size);
+        if (m_size % word_bits == 0)
+        {
+            m_words.pop_back();
+        }
+    }
+
+    std::size_t count() const noexcept
+    {
+        std::size_t __n = 0;
+        for (word_type __w : m_words)
+        {
+            __n += static_cast<std::size_t>(std::popcount(__w));
+        }
+        return __n;
+    }
+
+    bool any() const noexcept
+    {
+        word_type __acc = 0;
+        for (word_type __w : m_words)
+        {
+            __acc |= __w;
+        }
+        return __acc != 0;
+    }
+
+    bool all() const noexcept
+    {
+        if (m_words.empty())
+        {
+            return true;
+        }
+        word_type __acc = ~word_type{0};
+        const std::size_t __full = m_size / word_bits;
+        for (std::size_t __i = 0; __i < __full; ++__i)
+        {
+            __acc &= m_words[__i];
+        }
+        if (__acc != ~word_type{0})
+        {
+            return false;
+        }
+        return m_size % word_bits == 0 || m_words.back() == __bit(m_size) - 1;
+    }
+
+    bool none() const noexcept { return !any(); }
+
+    void flip() noexcept
+    {
+        for (word_type &__w : m_words)
+        {
+            __w = ~__w;
+        }
+        __clear_tail();
+    }
+
+    // first set (or cleared) bit at or after i, size() if there is none
+    std::size_t find_next(std::size_t i, bool value = true) const noexcept
+    {
+        if (i >= m_size)
+        {
+            return m_size;
+        }
+        std::size_t __wi = i / word_bits;
+        word_type __w = (value ? m_words[__wi] : ~m_words[__wi]) & (~word_type{0} << (i % word_bits));
+        for (;;)
+        {
+            if (__w)
+            {
+                const std::size_t __r = __wi * word_bits + static_cast<std::size_t>(std::countr_zero(__w));
+                return __r < m_size ? __r : m_size;
+            }
+            if (++__wi == m_words.size())
+            {
+                return m_size;
+            }
+            __w = value ? m_words[__wi] : ~m_words[__wi];
+        }
+    }
+
+    // number of set bits before i
+    std::size_t rank(std::size_t i) const noexcept
+    {
+        std::size_t __n = 0;
+        const std::size_t __full = i / word_bits;
+        for (std::size_t __w = 0; __w < __full; ++__w)
+        {
+            __n += static_cast<std::size_t>(std::popcount(m_words[__w]));
+        }
+        if (i % word_bits)
+        {
+            __n += static_cast<std::size_t>(std::popcount(m_words[__full] & (__bit(i) - 1)));
+        }
+        return __n;
+    }
+
+    // operands must have the same size
+    bitmap &operator&=(const bitmap &other) noexcept
+    {
+        for (std::size_t __i = 0; __i < m_words.size(); ++__i)
+        {
+            m_words[__i] &= other.m_words[__i];
+        }
+        return *this;
+    }
+
+    bitmap &operator|=(const bitmap &other) noexcept
+    {
+        for (std::size_t __i = 0; __i < m_words.size(); ++__i)
+        {
+            m_words[__i] |= other.m_words[__i];
+        }
+        return *this;
+    }
+
+    bitmap &operator^=(const bitmap &other) noexcept
+    {
+        for (std::size_t __i = 0; __i < m_words.size(); ++__i)
+        {
+            m_words[__i] ^= other.m_words[__i];
+        }
+        return *this;
+    }
+
+    std::span<const word_type> words() const noexcept { return m_words; }
+
+    friend bool operator==(const bitmap &lhs, const bitmap &rhs) noexcept
+    {
+        return lhs.m_size == rhs.m_size && lhs.m_words == rhs.m_words;
+    }
+
+private:
+    static constexpr std::size_t __word_count(std::size_t n) noexcept
+    {
+        return (n + word_bits - 1) / word_bits;
+    }
+
+    static constexpr word_type __bit(std::size_t i) noexcept
+    {
+        return word_type{1} << (i % word_bits);
+    }
+
+    void __clear_tail() noexcept
+    {
+        if (m_size % word_bits)
+        {
+            m_words.back() &= __bit(m_size) - 1;
+        }
+    }
+
+    std::vector<word_type> m_words;
+    std::size_t m_size = 0;
+};
+
+} // namespace detail
+} // namespace gb
@@ -0,0 +1,235 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "expected.h"
+
+// The caller's expected<T, E> is converted from the coroutine's return object, which is only
+// correct once the body has run (see get_return_object). GCC converts that late; Clang and MSVC
+// may convert right after get_return_object, before there is a result, so refuse to build there.
+#if !defined(__GNUC__) || defined(__clang__)
+#error "expected_coroutine.h needs GCC: the return object must be converted after the body has run"
+#endif
+
+// Lets a function returning gb::expected<T, E> be written as a coroutine that co_awaits other
+// expected values: a value resumes the coroutine with it, an error finishes the coroutine with
+// that error without running the rest of the body.
+//
+//   gb::expected<int, errc> parse_sum(std::string_view a, std::string_view b)
+//   {
+//       int x = co_await parse(a);
+//       int y = co_await parse(b);
+//       co_return x + y;
+//   }
+//
+// These coroutines never suspend past the point of returning to their caller, so their frames
+// are strictly nested and come from a per-thread stack: steady state performs no heap allocation.
+// The frame never escapes, which keeps it eligible for elision, but GCC does not elide it: each
+// call still sets up a frame, which makes a coroutine about three times slower than the same
+// function with handwritten early returns (bench/coroutine_bench). Keep them off the hottest paths.
+namespace gb {
+namespace detail {
+
+// LIFO frame storage for synchronous coroutines; frames that do not fit go to the heap
+class __frame_stack
+{
+public:
+    static constexpr std::size_t capacity = 64 * 1024;
+
+    static __frame_stack &local() noexcept
+    {
+        thread_local __frame_stack __stack;
+        return __stack;
+    }
+
+    void *allocate(std::size_t n)
+    {
+        n = __round(n);
+        if (!m_buffer)
+        {
+            m_buffer.reset(new std::byte[capacity]);
+        }
+        if (capacity - m_top >= n)
+        {
+            void *__p = m_buffer.get() + m_top;
+            m_top += n;
+            return __p;
+        }
+        return ::operator new(n);
+    }
+
+    void deallocate(void *p, std::size_t n) noexcept
+    {
+        n = __round(n);
+        auto *__b = static_cast<std::byte *>(p);
+        if (m_buffer && __b >= m_buffer.get() && __b < m_buffer.get() + capacity)
+        {
+            m_top -= n;
+        }
+        else
+        {
+            ::operator delete(p, n);
+        }
+    }
+
+private:
+    static constexpr std::size_t __round(std::size_t n) noexcept
+    {
+        constexpr std::size_t __a = alignof(std::max_align_t);
+        return (n + __a - 1) & ~(__a - 1);
+    }
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    std::size_t m_top = 0;
+};
+
+template <class T, class E>
+struct __expected_promise;
+
+// What the coroutine hands back to its caller. The result is written here rather than into the
+// promise because the frame is gone by the time the caller converts this to expected<T, E>.
+template <class T, class E>
+class __expected_return_object
+{
+public:
+    __expected_return_object(__expected_promise<T, E> &p) noexcept
+        : m_promise(&p)
+    {
+        p.m_result = &m_result;
+    }
+
+    __expected_return_object(__expected_return_object &&other) noexcept
+        : m_promise(other.m_promise), m_result(std::move(other.m_result))
+    {
+        // a result that is not there yet still has to land here
+        if (!m_result)
+        {
+            m_promise->m_result = &m_result;
+        }
+    }
+
+    __expected_return_object(const __expected_return_object &) = delete;
+    __expected_return_object &operator=(const __expected_return_object &) = delete;
+    __expected_return_object &operator=(__expected_return_object &&) = delete;
+
+    operator expected<T, E>() &&
+    {
+        return __take();
+    }
+
+    operator expected<T, E>() &
+    {
+        return __take();
+    }
+
+private:
+    // the body has run to completion (GCC only, see get_return_object), so there is a result
+    expected<T, E> __take()
+    {
+        return std::move(*m_result);
+    }
+
+    __expected_promise<T, E> *m_promise;
+    std::optional<expected<T, E>> m_result;
+};
+
+template <class Exp, class Promise>
+struct __expected_awaiter
+{
+    Exp &&m_exp;
+
+    bool await_ready() const noexcept
+    {
+        return m_exp.has_value();
+    }
+
+    // error: publish it as the coroutine's result and tear the coroutine down without resuming
+    void await_suspend(std::coroutine_handle<Promise> h)
+    {
+        if constexpr (std::is_void_v<expect_error_t<Exp>>)
+        {
+            h.promise().m_result->emplace(unexpect);
+        }
+        else
+        {
+            h.promise().m_result->emplace(unexpect, std::forward<Exp>(m_exp).error());
+        }
+        h.destroy();
+    }
+
+    expect_value_t<Exp> await_resume()
+    {
+        if constexpr (!std::is_void_v<expect_value_t<Exp>>)
+        {
+            return *std::forward<Exp>(m_exp);
+        }
+    }
+};
+
+template <class T, class E>
+struct __expected_promise
+{
+    std::optional<expected<T, E>> *m_result = nullptr;
+
+    static void *operator new(std::size_t n)
+    {
+        return __frame_stack::local().allocate(n);
+    }
+
+    static void operator delete(void *p, std::size_t n) noexcept
+    {
+        __frame_stack::local().deallocate(p, n);
+    }
+
+    // The caller gets its expected<T, E> by converting this object, which only works if the
+    // conversion happens once the coroutine has returned to it, by which time the body has run to
+    // completion. GCC does that (it initializes the return value from the object as the coroutine
+    // first returns); other compilers are rejected at the top of this file.
+    __expected_return_object<T, E> get_return_object() noexcept
+    {
+        return {*this};
+    }
+
+    std::suspend_never initial_suspend() const noexcept { return {}; }
+    std::suspend_never final_suspend() const noexcept { return {}; }
+
+    // co_return value; co_return unexpected(e); co_return {}; for a void value
+    void return_value(expected<T, E> r)
+    {
+        m_result->emplace(std::move(r));
+    }
+
+    void unhandled_exception()
+    {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+        throw;
+#else
+        std::terminate();
+#endif
+    }
+
+    // only expected values can be awaited, and their errors must convert to E
+    template <class Exp>
+        requires is_expect_v<Exp> &&
+                 (std::is_void_v<E> ? std::is_void_v<expect_error_t<Exp>>
+                                    : std::is_constructible_v<E, decltype(std::declval<Exp>().error())>)
+    __expected_awaiter<Exp, __expected_promise> await_transform(Exp &&exp) noexcept
+    {
+        return {std::forward<Exp>(exp)};
+    }
+};
+
+} // namespace detail
+} // namespace gb
+
+template <class T, class E, class... Args>
+struct std::coroutine_traits<gb::expected<T, E>, Args...>
+{
+    using promise_type = gb::detail::__expected_promise<T, E>;
+};
@@ -0,0 +1,452 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "expected.h"
+
+// One-shot future/promise pair whose shared state holds an expected<T, E> directly: no
+// exception_ptr, one allocation per pair (recycled through a per-thread pool), and a single
+// atomic word for readiness, waiting, continuations and the lifetime of both ends.
+//
+//   gb::promise<int, errc> p;
+//   gb::future<int, errc> f = p.get_future();
+//   auto g = std::move(f).then([](int v) { return v * 2; });   // like transform
+//   p.set_value(21);
+//   g.get();                                                   // expected<int, errc>(42)
+namespace gb {
+
+template <class T, class E>
+class future;
+
+template <class T, class E>
+class promise;
+
+namespace detail {
+
+// Per-thread free list of Size byte blocks; blocks freed on another thread join that thread's list
+template <std::size_t Size, std::size_t Align>
+class __block_pool
+{
+    static constexpr std::size_t __max_cached = 256;
+
+    struct __node
+    {
+        __node *next;
+    };
+
+    struct __list
+    {
+        __node *head = nullptr;
+        std::size_t count = 0;
+
+        ~__list()
+        {
+            while (head)
+            {
+                ::operator delete(std::exchange(head, head->next), std::align_val_t{Align});
+            }
+        }
+    };
+
+    static __list &__local() noexcept
+    {
+        thread_local __list __l;
+        return __l;
+    }
+
+public:
+    static_assert(Size >= sizeof(__node));
+
+    static void *allocate()
+    {
+        auto &__l = __local();
+        if (__l.head)
+        {
+            --__l.count;
+            return std::exchange(__l.head, __l.head->next);
+        }
+        return ::operator new(Size, std::align_val_t{Align});
+    }
+
+    static void deallocate(void *p) noexcept
+    {
+        auto &__l = __local();
+        if (__l.count < __max_cached)
+        {
+            ++__l.count;
+            __l.head = ::new (p) __node{__l.head};
+            return;
+        }
+        ::operator delete(p, std::align_val_t{Align});
+    }
+};
+
+template <class T, class E>
+struct __future_state;
+
+template <class T, class E>
+struct __continuation
+{
+    // consumes the result of the state, or is called with nullptr when the promise was broken
+    void (*m_run)(__continuation *, std::optional<expected<T, E>> *) noexcept;
+};
+
+template <class T, class E>
+struct __future_state
+{
+    enum : std::uint32_t
+    {
+        __ready = 1,         // m_result is set, or the promise was broken
+        __broken = 2,        // the promise went away without a result
+        __waiting = 4,       // a thread sleeps in wait()
+        __continued = 8,     // m_continuation is set and runs once ready
+        __promise_gone = 16,
+        __future_gone = 32,
+    };
+
+    std::atomic<std::uint32_t> m_flags{0};
+    std::optional<expected<T, E>> m_result;
+    __continuation<T, E> *m_continuation = nullptr;
+
+    static void *operator new(std::size_t)
+    {
+        return __block_pool<sizeof(__future_state), alignof(__future_state)>::allocate();
+    }
+
+    static void operator delete(void *p) noexcept
+    {
+        __block_pool<sizeof(__future_state), alignof(__future_state)>::deallocate(p);
+    }
+
+    // publishes the outcome (m_result is set unless broken); runs the continuation or wakes the
+    // waiter. Only the promise calls this, and it still holds its reference while doing so.
+    void complete(std::uint32_t flags) noexcept
+    {
+        const std::uint32_t __old = m_flags.fetch_or(__ready | flags, std::memory_order_acq_rel);
+        if (__old & __continued)
+        {
+            m_continuation->m_run(m_continuation, (flags & __broken) ? nullptr : &m_result);
+        }
+        else if (__old & __waiting)
+        {
+            m_flags.notify_all();
+        }
+    }
+
+    void wait() noexcept
+    {
+        std::uint32_t __s = m_flags.load(std::memory_order_acquire);
+        while (!(__s & __ready))
+        {
+            if (!(__s & __waiting))
+            {
+                __s = m_flags.fetch_or(__waiting, std::memory_order_acquire) | __waiting;
+                continue;
+            }
+            m_flags.wait(__s, std::memory_order_acquire);
+            __s = m_flags.load(std::memory_order_acquire);
+        }
+    }
+
+    // installs a continuation; runs it right away if the outcome is already there
+    void attach(__continuation<T, E> *c) noexcept
+    {
+        m_continuation = c;
+        const std::uint32_t __old = m_flags.fetch_or(__continued, std::memory_order_acq_rel);
+        if (__old & __ready)
+        {
+            c->m_run(c, (__old & __broken) ? nullptr : &m_result);
+        }
+    }
+
+    // the last of the two ends to let go frees the state
+    void release(std::uint32_t gone) noexcept
+    {
+        const std::uint32_t __other = gone == __promise_gone ? __future_gone : __promise_gone;
+        if (m_flags.fetch_or(gone, std::memory_order_acq_rel) & __other)
+        {
+            delete this;
+        }
+    }
+};
+
+// f applied to a settled expected the way the monadic operations apply it: transform for plain
+// results, and_then for expected results
+template <class T, class E, class F>
+auto __apply_continuation(expected<T, E> &&r, F &f)
+{
+    using __r_t = std::remove_cvref_t<
+        typename std::conditional_t<std::is_void_v<T>, std::invoke_result<F &>, std::invoke_result<F &, T>>::type>;
+
+    if constexpr (!is_expect_v<__r_t>)
+    {
+        return transform_impl(std::move(r), f);
+    }
+    else if constexpr (std::is_same_v<__r_t, expected<T, E>>)
+    {
+        return and_then_impl(std::move(r), f);
+    }
+    else
+    {
+        static_assert(std::is_same_v<expect_error_t<__r_t>, E>, "then() must keep the error type");
+        if (r.has_value())
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                return std::invoke(f);
+            }
+            else
+            {
+                return std::invoke(f, *std::move(r));
+            }
+        }
+        if constexpr (std::is_void_v<E>)
+        {
+            return __r_t(unexpect);
+        }
+        else
+        {
+            return __r_t(unexpect, std::move(r).error());
+        }
+    }
+}
+
+template <class T, class E, class F>
+using __continuation_result_t = decltype(__apply_continuation(std::declval<expected<T, E> &&>(), std::declval<F &>()));
+
+// lets combinators attach their own continuation nodes to a future's state
+struct __future_access
+{
+    // the caller takes over the future's reference and drops it with release(__future_gone)
+    template <class T, class E>
+    static __future_state<T, E> *take(future<T, E> &f) noexcept
+    {
+        return std::exchange(f.m_state, nullptr);
+    }
+};
+
+} // namespace detail
+
+// Producing end. Destroying a promise that was never satisfied breaks it: the future becomes
+// ready and get() fails like value() on an error.
+template <class T, class E>
+class promise
+{
+    using __state_t = detail::__future_state<T, E>;
+
+public:
+    promise()
+        : m_state(new __state_t())
+    {
+    }
+
+    promise(promise &&other) noexcept
+        : m_state(std::exchange(other.m_state, nullptr)), m_future_retrieved(other.m_future_retrieved)
+    {
+    }
+
+    promise &operator=(promise &&other) noexcept
+    {
+        promise(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    promise(const promise &) = delete;
+    promise &operator=(const promise &) = delete;
+
+    ~promise()
+    {
+        if (!m_state)
+        {
+            return;
+        }
+        if (!(m_state->m_flags.load(std::memory_order_relaxed) & __state_t::__ready))
+        {
+            m_state->complete(__state_t::__broken);
+        }
+        if (!m_future_retrieved)
+        {
+            m_state->m_flags.fetch_or(__state_t::__future_gone, std::memory_order_relaxed);
+        }
+        m_state->release(__state_t::__promise_gone);
+    }
+
+    void swap(promise &other) noexcept
+    {
+        std::swap(m_state, other.m_state);
+        std::swap(m_future_retrieved, other.m_future_retrieved);
+    }
+
+    // may be called once
+    future<T, E> get_future() noexcept
+    {
+        m_future_retrieved = true;
+        return future<T, E>(m_state);
+    }
+
+    // the setters may be called once, and only one of them
+    void set(expected<T, E> r)
+    {
+        m_state->m_result.emplace(std::move(r));
+        m_state->complete(0);
+    }
+
+    template <class... Args>
+    void set_value(Args &&...args)
+    {
+        if constexpr (std::is_void_v<T>)
+        {
+            static_assert(sizeof...(Args) == 0);
+            m_state->m_result.emplace(expect);
+        }
+        else
+        {
+            m_state->m_result.emplace(std::in_place, std::forward<Args>(args)...);
+        }
+        m_state->complete(0);
+    }
+
+    template <class... Args>
+    void set_error(Args &&...args)
+    {
+        m_state->m_result.emplace(unexpect, std::forward<Args>(args)...);
+        m_state->complete(0);
+    }
+
+private:
+    __state_t *m_state;
+    bool m_future_retrieved = false;
+};
+
+// Consuming end
+template <class T, class E>
+class future
+{
+    using __state_t = detail::__future_state<T, E>;
+
+    template <class, class>
+    friend class promise;
+
+    template <class, class>
+    friend class future;
+
+    friend struct detail::__future_access;
+
+    explicit future(__state_t *s) noexcept
+        : m_state(s)
+    {
+    }
+
+public:
+    using value_type = expected<T, E>;
+
+    future() noexcept = default;
+
+    future(future &&other) noexcept
+        : m_state(std::exchange(other.m_state, nullptr))
+    {
+    }
+
+    future &operator=(future &&other) noexcept
+    {
+        future(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    future(const future &) = delete;
+    future &operator=(const future &) = delete;
+
+    ~future()
+    {
+        if (m_state)
+        {
+            m_state->release(__state_t::__future_gone);
+        }
+    }
+
+    void swap(future &other) noexcept
+    {
+        std::swap(m_state, other.m_state);
+    }
+
+    bool valid() const noexcept { return m_state != nullptr; }
+
+    bool is_ready() const noexcept
+    {
+        return m_state->m_flags.load(std::memory_order_acquire) & __state_t::__ready;
+    }
+
+    // sleeps on the state word until the promise is settled
+    void wait() const noexcept
+    {
+        m_state->wait();
+    }
+
+    // waits, then moves the result out; the future is left invalid
+    value_type get() &&
+    {
+        wait();
+        future __hold(std::move(*this));
+        if (__hold.m_state->m_flags.load(std::memory_order_relaxed) & __state_t::__broken)
+        {
+            detail::__fail_bad_expect_access();
+        }
+        return std::move(*__hold.m_state->m_result);
+    }
+
+    // Future of f applied to the result, run by whichever thread settles the result (or right
+    // here if it already is): a plain return value goes through transform_impl, an expected return
+    // value chains like and_then. Errors skip f. There is no one to rethrow to on the settling
+    // thread, so an exception from f breaks the returned future: its get() fails like value() on
+    // an error, and the exception itself is lost. Without exceptions f is just called.
+    template <class F>
+    future<expect_value_t<detail::__continuation_result_t<T, E, std::decay_t<F>>>, E> then(F &&f) &&
+    {
+        using __r_t = detail::__continuation_result_t<T, E, std::decay_t<F>>;
+        using __next_t = promise<expect_value_t<__r_t>, E>;
+
+        struct __node : detail::__continuation<T, E>
+        {
+            std::decay_t<F> m_f;
+            __next_t m_next;
+
+            static void __run(detail::__continuation<T, E> *c, std::optional<expected<T, E>> *r) noexcept
+            {
+                auto *__self = static_cast<__node *>(c);
+                if (r)
+                {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+                    try
+                    {
+                        __self->m_next.set(detail::__apply_continuation(std::move(**r), __self->m_f));
+                    }
+                    catch (...)
+                    {
+                        // a throwing f must not terminate the thread that settled the result
+                    }
+#else
+                    __self->m_next.set(detail::__apply_continuation(std::move(**r), __self->m_f));
+#endif
+                }
+                delete __self; // an unsatisfied m_next breaks the next future
+            }
+        };
+
+        auto *__n = new __node{{&__node::__run}, std::forward<F>(f), __next_t()};
+        auto __result = __n->m_next.get_future();
+        future __hold(std::move(*this));
+        __hold.m_state->attach(__n);
+        return __result;
+    }
+
+private:
+    __state_t *m_state = nullptr;
+};
+
+} // namespace gb
@@ -0,0 +1,253 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "expected.h"
+
+// Pull-based stream of results: the producer only runs when the consumer asks for the next
+// element, so a slow consumer holds back the producer without any buffering.
+//
+//   gb::generator<gb::expected<record, parse_error>> parse(reader &in)
+//   {
+//       gb::expected<record, parse_error> r;
+//       while (in.next(r))          // refills r in place
+//       {
+//           co_yield r;             // handed out by reference, not copied
+//       }
+//   }
+//
+//   for (auto &r : parse(in))                   // every record and every error
+//   for (auto &r : parse(in).stop_on_error())   // ends after the first error, which is yielded
+//   for (auto &r : parse(in).skip_errors())     // values only; errors are counted and dropped
+//
+// An lvalue expected is yielded in place. Anything else (a value, unexpected(e), a temporary
+// expected) is built in one slot inside the coroutine frame that every yield reuses, so past the
+// frame itself streaming allocates nothing. In skip mode an error does not even suspend the
+// producer.
+namespace gb {
+
+template <class Exp>
+class generator;
+
+namespace detail {
+
+enum class __generator_mode : unsigned char
+{
+    __yield_errors,
+    __stop_on_error,
+    __skip_errors
+};
+
+template <class Exp>
+struct __generator_promise
+{
+    Exp *m_current = nullptr;
+    std::optional<Exp> m_slot;
+    std::size_t m_skipped = 0;
+    __generator_mode m_mode = __generator_mode::__yield_errors;
+    bool m_stopped = false;
+
+    generator<Exp> get_return_object() noexcept;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    std::suspend_always final_suspend() const noexcept { return {}; }
+
+    struct __yield_awaiter
+    {
+        bool m_skip;
+
+        bool await_ready() const noexcept { return m_skip; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        void await_resume() const noexcept {}
+    };
+
+    __yield_awaiter yield_value(Exp &e) noexcept
+    {
+        return __yield(e);
+    }
+
+    template <class U>
+        requires std::is_constructible_v<Exp, U>
+    __yield_awaiter yield_value(U &&u)
+    {
+        return __yield(m_slot.emplace(std::forward<U>(u)));
+    }
+
+    void return_void() const noexcept {}
+
+    void unhandled_exception()
+    {
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+        throw;
+#else
+        std::terminate();
+#endif
+    }
+
+    // a generator only yields; it cannot wait on anything
+    template <class A>
+    void await_transform(A &&) = delete;
+
+    __yield_awaiter __yield(Exp &e) noexcept
+    {
+        if (!e.has_value())
+        {
+            if (m_mode == __generator_mode::__skip_errors)
+            {
+                ++m_skipped;
+                return {true};
+            }
+            m_stopped = m_mode == __generator_mode::__stop_on_error;
+        }
+        m_current = std::addressof(e);
+        return {false};
+    }
+};
+
+} // namespace detail
+
+template <class Exp>
+class [[nodiscard]] generator : public std::ranges::view_interface<generator<Exp>>
+{
+    static_assert(is_expect_v<Exp>, "generator yields expected values");
+
+public:
+    using promise_type = detail::__generator_promise<Exp>;
+
+private:
+    using __handle_t = std::coroutine_handle<promise_type>;
+
+    class __iterator
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = Exp;
+        using difference_type = std::ptrdiff_t;
+
+        __iterator() = default;
+
+        explicit __iterator(__handle_t h) noexcept
+            : m_handle(h)
+        {
+        }
+
+        // the element stays valid until the iterator is incremented
+        Exp &operator*() const noexcept
+        {
+            return *m_handle.promise().m_current;
+        }
+
+        Exp *operator->() const noexcept
+        {
+            return m_handle.promise().m_current;
+        }
+
+        __iterator &operator++()
+        {
+            if (m_handle.promise().m_stopped)
+            {
+                m_handle = nullptr;
+                return *this;
+            }
+            m_handle.resume();
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;
+        }
+
+        friend bool operator==(const __iterator &it, std::default_sentinel_t) noexcept
+        {
+            return !it.m_handle || it.m_handle.done();
+        }
+
+    private:
+        __handle_t m_handle;
+    };
+
+public:
+    generator() noexcept = default;
+
+    explicit generator(__handle_t h) noexcept
+        : m_handle(h)
+    {
+    }
+
+    generator(generator &&other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    generator &operator=(generator &&other) noexcept
+    {
+        generator(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    generator(const generator &) = delete;
+    generator &operator=(const generator &) = delete;
+
+    ~generator()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    void swap(generator &other) noexcept
+    {
+        std::swap(m_handle, other.m_handle);
+    }
+
+    // ends the stream after the first error; that error is still yielded
+    generator stop_on_error() && noexcept
+    {
+        m_handle.promise().m_mode = detail::__generator_mode::__stop_on_error;
+        return std::move(*this);
+    }
+
+    // yields values only; errors are counted (see skipped()) and the producer carries on
+    generator skip_errors() && noexcept
+    {
+        m_handle.promise().m_mode = detail::__generator_mode::__skip_errors;
+        return std::move(*this);
+    }
+
+    std::size_t skipped() const noexcept
+    {
+        return m_handle.promise().m_skipped;
+    }
+
+    // starts the producer; may be called once
+    __iterator begin()
+    {
+        m_handle.resume();
+        return __iterator(m_handle);
+    }
+
+    std::default_sentinel_t end() const noexcept
+    {
+        return std::default_sentinel;
+    }
+
+private:
+    __handle_t m_handle;
+};
+
+template <class Exp>
+generator<Exp> detail::__generator_promise<Exp>::get_return_object() noexcept
+{
+    return generator<Exp>(std::coroutine_handle<__generator_promise>::from_promise(*this));
+}
+
+} // namespace gb
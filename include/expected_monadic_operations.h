@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <type_traits>
 #include "expected_base.h"
 #include "expected_type_traits.h"
@@ -10,17 +11,18 @@ namespace gb {
 namespace detail {
 template<class Exp, class F>
     requires(!std::is_void_v<expect_value_t<Exp>>)
-constexpr std::decay_t<Exp> and_then_impl(Exp&& exp, F&& f) noexcept(std::is_nothrow_invocable_v<F, expect_value_t<Exp>>)
+constexpr std::decay_t<Exp> and_then_impl(Exp&& exp, F&& f GB_EXPECTED_TRACE_PARAM) noexcept(std::is_nothrow_invocable_v<F, expect_value_t<Exp>>)
 {
     if (std::forward<Exp>(exp).has_value())
         return std::invoke(std::forward<F>(f), *std::forward<Exp>(exp));
 
+    GB_EXPECTED_TRACE(propagated);
     return std::forward<Exp>(exp);
 }
 
 template<class Exp, class F>
     requires std::is_void_v<expect_value_t<Exp>>
-constexpr std::decay_t<Exp> and_then_impl(Exp&& exp, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+constexpr std::decay_t<Exp> and_then_impl(Exp&& exp, F&& f GB_EXPECTED_TRACE_PARAM) noexcept(std::is_nothrow_invocable_v<F>)
 {
     if (std::forward<Exp>(exp).has_value())
     {
@@ -35,12 +37,13 @@ constexpr std::decay_t<Exp> and_then_impl(Exp&& exp, F&& f) noexcept(std::is_not
         }
     }
 
+    GB_EXPECTED_TRACE(propagated);
     return std::forward<Exp>(exp);
 }
 
 template<class Exp, class F>
     requires(!std::is_void_v<expect_value_t<Exp>>)
-constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f)
+constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f GB_EXPECTED_TRACE_PARAM)
 {
     using result_t = value_transformed_t<Exp, F>;
     using r_value_t = expect_value_t<result_t>;
@@ -58,6 +61,7 @@ constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f)
         }
     }
 
+    GB_EXPECTED_TRACE(propagated);
     if constexpr (std::is_void_v<expect_error_t<Exp>>)
     {
         return unexpect;
@@ -70,7 +74,7 @@ constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f)
 
 template<class Exp, class F>
     requires std::is_void_v<expect_value_t<Exp>>
-constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f)
+constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f GB_EXPECTED_TRACE_PARAM)
 {
     using result_t = value_transformed_t<Exp, F>;
     using r_value_t = expect_value_t<result_t>;
@@ -88,6 +92,7 @@ constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f)
         }
     }
 
+    GB_EXPECTED_TRACE(propagated);
     if constexpr (std::is_void_v<expect_error_t<Exp>>)
     {
         return unexpect;
@@ -100,10 +105,11 @@ constexpr value_transformed_t<Exp, F> transform_impl(Exp&& exp, F&& f)
 
 template<class Exp, class F>
     requires(!std::is_void_v<expect_error_t<Exp>>)
-constexpr std::decay_t<Exp> or_else_impl(Exp&& exp, F&& f) noexcept(std::is_nothrow_invocable_v<F, expect_error_t<Exp>>)
+constexpr std::decay_t<Exp> or_else_impl(Exp&& exp, F&& f GB_EXPECTED_TRACE_PARAM) noexcept(std::is_nothrow_invocable_v<F, expect_error_t<Exp>>)
 {
     if (!std::forward<Exp>(exp).has_value())
     {
+        GB_EXPECTED_TRACE(handled);
         if constexpr (std::is_same_v<std::invoke_result_t<F, expect_error_t<Exp>>, std::decay_t<Exp>>)
         {
             return std::invoke(std::forward<F>(f), std::forward<Exp>(exp).error());
@@ -118,10 +124,11 @@ constexpr std::decay_t<Exp> or_else_impl(Exp&& exp, F&& f) noexcept(std::is_noth
 
 template<class Exp, class F>
     requires std::is_void_v<expect_error_t<Exp>>
-constexpr std::decay_t<Exp> or_else_impl(Exp&& exp, F&& f) noexcept(std::is_nothrow_invocable_v<F>)
+constexpr std::decay_t<Exp> or_else_impl(Exp&& exp, F&& f GB_EXPECTED_TRACE_PARAM) noexcept(std::is_nothrow_invocable_v<F>)
 {
     if (!std::forward<Exp>(exp).has_value())
     {
+        GB_EXPECTED_TRACE(handled);
         if constexpr (std::is_same_v<std::invoke_result_t<F>, std::decay_t<Exp>>)
         {
             return std::invoke(std::forward<F>(f));
@@ -154,7 +161,14 @@ constexpr error_transformed_t<Exp, F> transform_error_impl(Exp&& exp, F&& f) noe
         }
     }
 
-    return *std::forward<Exp>(exp);
+    if constexpr (std::is_void_v<expect_value_t<Exp>>)
+    {
+        return result_t();
+    }
+    else
+    {
+        return *std::forward<Exp>(exp);
+    }
 }
 
 template<class Exp, class F>
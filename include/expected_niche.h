@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace gb {
+
+// Customization point that lets expected keep its discriminant inside the payload instead
+// of a separate bool. A specialization declares that the object representation of every
+// valid T, read as word_type, has its lowest bit cleared:
+//
+//   template<> struct gb::niche_traits<my_handle> { using word_type = std::uint64_t; };
+//
+// word_type must be an unsigned integer of the same size as T, and T must be trivially copyable.
+// expected<T, E> then packs any trivially copyable E smaller than T into the same word, and its
+// error() returns the error by value (see expected_value_error_niche.h).
+template<class T>
+struct niche_traits
+{
+};
+
+// Declares that every T is aligned to at least 2, so that the low bit of a T* is free and
+// expected<T*, E> can keep its discriminant there. It holds on its own for scalar pointees; a
+// class opts in where it is declared, and must then be complete wherever expected<T*, E> is used
+// (a check, not an assumption):
+//
+//   struct node;
+//   template<> inline constexpr bool gb::niche_pointee<node> = true;
+//
+// The answer deliberately never depends on whether T is complete at the point of use, since that
+// would give expected<T*, E> a different layout in different translation units.
+template<class T>
+inline constexpr bool niche_pointee = [] {
+    if constexpr (std::is_scalar_v<T>)
+    {
+        return alignof(T) >= 2;
+    }
+    else
+    {
+        return false;
+    }
+}();
+
+template<class T>
+    requires std::is_object_v<T> && niche_pointee<std::remove_cv_t<T>>
+struct niche_traits<T*>
+{
+    static_assert(sizeof(T) > 0 && alignof(T) >= 2, "niche_pointee<T> requires a complete T aligned to at least 2");
+
+    using word_type = std::uintptr_t;
+};
+
+namespace detail {
+
+template<class T>
+concept has_niche = requires { typename niche_traits<T>::word_type; } &&
+                    std::is_unsigned_v<typename niche_traits<T>::word_type> &&
+                    sizeof(typename niche_traits<T>::word_type) == sizeof(T) &&
+                    std::is_trivially_copyable_v<T>;
+
+// E fits in the bits of T's word above the discriminant bit
+template<class T, class E>
+concept niche_packable = has_niche<T> &&
+                         std::is_trivially_copyable_v<E> &&
+                         sizeof(E) < sizeof(T);
+
+template<class T>
+using niche_word_t = typename niche_traits<T>::word_type;
+
+static constexpr std::uintmax_t niche_tag = 1;
+
+template<class W, class E>
+constexpr W niche_pack(const E& e) noexcept
+{
+    const auto bytes = std::bit_cast<std::array<unsigned char, sizeof(E)>>(e);
+    W word = 0;
+    for (std::size_t i = 0; i < sizeof(E); ++i)
+    {
+        word |= static_cast<W>(bytes[i]) << (8 * i);
+    }
+    return static_cast<W>(word << 1) | static_cast<W>(niche_tag);
+}
+
+template<class E, class W>
+constexpr E niche_unpack(W word) noexcept
+{
+    std::array<unsigned char, sizeof(E)> bytes{};
+    word >>= 1;
+    for (std::size_t i = 0; i < sizeof(E); ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(word >> (8 * i));
+    }
+    return std::bit_cast<E>(bytes);
+}
+
+} // namespace detail
+} // namespace gb
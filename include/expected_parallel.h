@@ -0,0 +1,536 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "expected.h"
+
+namespace gb {
+namespace execution {
+
+struct sequenced_policy
+{
+};
+
+// threads == 0 uses every thread of the shared pool; grain == 0 picks the chunk size from the
+// input size
+struct parallel_policy
+{
+    unsigned threads = 0;
+    std::size_t grain = 0;
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+} // namespace execution
+
+namespace detail {
+
+// Fork-join pool: run() hands one job to up to `width` participants, the calling thread being
+// one of them, and returns once all of them are done. The mutex is only taken to dispatch and
+// to join, never by the job itself. A run() issued from inside a job, or while another thread
+// owns the pool, executes on the calling thread alone. An exception thrown by the job on any
+// participant sets cancelled(), which the job polls to give up early, and is rethrown from run()
+// once every participant has returned; when several throw, the first one wins.
+class __fork_join_pool
+{
+public:
+    explicit __fork_join_pool(unsigned participants)
+    {
+        const unsigned __workers = participants > 1 ? participants - 1 : 0;
+        m_threads.reserve(__workers);
+        for (unsigned __i = 0; __i < __workers; ++__i)
+        {
+            m_threads.emplace_back([this, __i] { __worker(__i + 1); });
+        }
+    }
+
+    ~__fork_join_pool()
+    {
+        {
+            std::lock_guard __lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto &__t : m_threads)
+        {
+            __t.join();
+        }
+    }
+
+    __fork_join_pool(const __fork_join_pool &) = delete;
+    __fork_join_pool &operator=(const __fork_join_pool &) = delete;
+
+    static __fork_join_pool &shared()
+    {
+        static __fork_join_pool __pool(std::max(1u, std::thread::hardware_concurrency()));
+        return __pool;
+    }
+
+    unsigned size() const noexcept
+    {
+        return static_cast<unsigned>(m_threads.size()) + 1;
+    }
+
+    // job(participant) with participant in [0, width); 0 is the calling thread
+    template <class F>
+    void run(unsigned width, F &job)
+    {
+        std::unique_lock __owner(m_run_mutex, std::defer_lock);
+        if (width <= 1 || __in_job() || !__owner.try_lock())
+        {
+            __in_job_scope __scope;
+            job(0u);
+            return;
+        }
+
+        width = std::min(width, size());
+        {
+            std::lock_guard __lock(m_mutex);
+            m_job = &job;
+            m_call = [](void *j, unsigned p) { (*static_cast<F *>(j))(p); };
+            m_width = width;
+            m_pending = width - 1;
+            m_exception = nullptr;
+            m_cancelled.store(false, std::memory_order_relaxed);
+            ++m_generation;
+        }
+        m_wake.notify_all();
+
+        {
+            __in_job_scope __scope;
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+            try
+            {
+                job(0u);
+            }
+            catch (...)
+            {
+                __cancel(std::current_exception());
+            }
+#else
+            job(0u);
+#endif
+        }
+
+        // the job lives on the caller's stack: no participant may still be in it on return
+        std::exception_ptr __exception;
+        {
+            std::unique_lock __lock(m_mutex);
+            m_done.wait(__lock, [this] { return m_pending == 0; });
+            m_job = nullptr;
+            m_call = nullptr;
+            __exception = std::exchange(m_exception, nullptr);
+        }
+        if (__exception)
+        {
+            std::rethrow_exception(__exception);
+        }
+    }
+
+    // set once a participant of the current run() has thrown
+    bool cancelled() const noexcept
+    {
+        return m_cancelled.load(std::memory_order_relaxed);
+    }
+
+private:
+    static bool &__in_job() noexcept
+    {
+        thread_local bool __flag = false;
+        return __flag;
+    }
+
+    struct __in_job_scope
+    {
+        bool m_previous = std::exchange(__in_job(), true);
+        ~__in_job_scope() { __in_job() = m_previous; }
+    };
+
+    void __worker(unsigned participant)
+    {
+        __in_job() = true;
+        std::uint64_t __seen = 0;
+        for (;;)
+        {
+            void *__job;
+            void (*__call)(void *, unsigned);
+            {
+                std::unique_lock __lock(m_mutex);
+                m_wake.wait(__lock, [&] { return m_stop || m_generation != __seen; });
+                if (m_stop)
+                {
+                    return;
+                }
+                __seen = m_generation;
+                if (participant >= m_width)
+                {
+                    continue;
+                }
+                __job = m_job;
+                __call = m_call;
+            }
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+            try
+            {
+                __call(__job, participant);
+            }
+            catch (...)
+            {
+                __cancel(std::current_exception());
+            }
+#else
+            __call(__job, participant);
+#endif
+
+            std::lock_guard __lock(m_mutex);
+            if (--m_pending == 0)
+            {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    void __cancel(std::exception_ptr e) noexcept
+    {
+        m_cancelled.store(true, std::memory_order_relaxed);
+        std::lock_guard __lock(m_mutex);
+        if (!m_exception)
+        {
+            m_exception = std::move(e);
+        }
+    }
+
+    std::mutex m_run_mutex;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    void *m_job = nullptr;
+    void (*m_call)(void *, unsigned) = nullptr;
+    unsigned m_width = 0;
+    unsigned m_pending = 0;
+    std::uint64_t m_generation = 0;
+    std::exception_ptr m_exception;
+    std::atomic<bool> m_cancelled{false};
+    bool m_stop = false;
+    std::vector<std::thread> m_threads;
+};
+
+// Per element step of parallel_transform. An expected element goes through f like transform
+// (or and_then, when f itself returns an expected); a plain element is passed to f, which then
+// has to return an expected. Proxy references to expected are classified by the range's value
+// type and materialized before the call.
+template <class Elem, class Value, class F>
+struct __parallel_step
+{
+    using __elem_t = std::remove_cvref_t<Value>;
+
+    static constexpr auto __deduce()
+    {
+        if constexpr (is_expect_v<__elem_t>)
+        {
+            using __value_t = expect_value_t<__elem_t>;
+            using __error_t = expect_error_t<__elem_t>;
+            using __r_t = std::remove_cvref_t<
+                typename std::conditional_t<std::is_void_v<__value_t>, std::invoke_result<F &>,
+                                            std::invoke_result<F &, __value_t>>::type>;
+            if constexpr (is_expect_v<__r_t>)
+            {
+                static_assert(std::is_same_v<expect_error_t<__r_t>, __error_t>,
+                              "f must return an expected with the error type of the input");
+                return std::type_identity<__r_t>{};
+            }
+            else
+            {
+                return std::type_identity<expected<__r_t, __error_t>>{};
+            }
+        }
+        else
+        {
+            using __r_t = std::remove_cvref_t<std::invoke_result_t<F &, Elem>>;
+            static_assert(is_expect_v<__r_t>, "for plain inputs f must return an expected");
+            return std::type_identity<__r_t>{};
+        }
+    }
+
+    using type = typename decltype(__deduce())::type;
+
+    // f returns an expected itself, as for and_then
+    static constexpr bool __fallible = [] {
+        if constexpr (!is_expect_v<__elem_t>)
+        {
+            return true;
+        }
+        else if constexpr (std::is_void_v<expect_value_t<__elem_t>>)
+        {
+            return is_expect_v<std::invoke_result_t<F &>>;
+        }
+        else
+        {
+            return is_expect_v<std::invoke_result_t<F &, expect_value_t<__elem_t>>>;
+        }
+    }();
+
+    static constexpr type apply(Elem &&e, F &f)
+    {
+        if constexpr (is_expect_v<__elem_t> && !std::is_same_v<std::remove_cvref_t<Elem>, __elem_t>)
+        {
+            return __parallel_step<__elem_t, __elem_t, F>::apply(__elem_t(std::forward<Elem>(e)), f);
+        }
+        else if constexpr (!is_expect_v<__elem_t>)
+        {
+            return std::invoke(f, std::forward<Elem>(e));
+        }
+        else if constexpr (!__fallible)
+        {
+            return transform_impl(std::forward<Elem>(e), f);
+        }
+        else
+        {
+            if (!e.has_value())
+            {
+                if constexpr (std::is_void_v<expect_error_t<__elem_t>>)
+                {
+                    return type(unexpect);
+                }
+                else
+                {
+                    return type(unexpect, std::forward<Elem>(e).error());
+                }
+            }
+            if constexpr (std::is_void_v<expect_value_t<__elem_t>>)
+            {
+                return std::invoke(f);
+            }
+            else
+            {
+                return std::invoke(f, *std::forward<Elem>(e));
+            }
+        }
+    }
+};
+
+// Shared state of one parallel_transform call. m_stop is the lowest failing index seen so far:
+// chunks are claimed in increasing order and elements at or past m_stop are skipped, so every
+// element before the first failing one is still evaluated and the reported error is the one a
+// sequential pass would report. Each participant keeps its own error, nothing is shared but
+// the two atomics.
+template <class E>
+struct __parallel_state
+{
+    struct alignas(64) __slot
+    {
+        std::size_t index = std::numeric_limits<std::size_t>::max();
+        std::optional<std::conditional_t<std::is_void_v<E>, std::monostate, E>> error;
+    };
+
+    explicit __parallel_state(unsigned participants)
+        : m_slots(participants)
+    {
+    }
+
+    alignas(64) std::atomic<std::size_t> m_next{0};
+    alignas(64) std::atomic<std::size_t> m_stop{std::numeric_limits<std::size_t>::max()};
+    std::vector<__slot> m_slots;
+
+    template <class Exp>
+    void fail(unsigned participant, std::size_t i, Exp &&r)
+    {
+        auto &__s = m_slots[participant];
+        if (i < __s.index)
+        {
+            __s.index = i;
+            if constexpr (std::is_void_v<E>)
+            {
+                __s.error.emplace();
+            }
+            else
+            {
+                __s.error.emplace(std::forward<Exp>(r).error());
+            }
+        }
+
+        std::size_t __stop = m_stop.load(std::memory_order_relaxed);
+        while (i < __stop && !m_stop.compare_exchange_weak(__stop, i, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    __slot *first_error() noexcept
+    {
+        __slot *__first = nullptr;
+        for (auto &__s : m_slots)
+        {
+            if (__s.error && (!__first || __s.index < __first->index))
+            {
+                __first = &__s;
+            }
+        }
+        return __first;
+    }
+};
+
+template <class Range, class F, class Out>
+auto __parallel_transform_into(const execution::parallel_policy &policy, Range &&input, Out out, F &f)
+{
+    using __step = __parallel_step<std::ranges::range_reference_t<Range>, std::ranges::range_value_t<Range>, F>;
+    using __r_t = typename __step::type;
+    using __value_t = expect_value_t<__r_t>;
+    using __error_t = expect_error_t<__r_t>;
+    using result_t = expected<void, __error_t>;
+
+    const std::size_t __n = static_cast<std::size_t>(std::ranges::size(input));
+    auto &__pool = __fork_join_pool::shared();
+    const unsigned __width = std::max(1u, policy.threads ? std::min(policy.threads, __pool.size()) : __pool.size());
+    const std::size_t __grain =
+        policy.grain ? policy.grain : std::max<std::size_t>(1024, __n / (std::size_t{__width} * 8) + 1);
+
+    __parallel_state<__error_t> __state(__width);
+    auto __first = std::ranges::begin(input);
+
+    auto __job = [&](unsigned participant) {
+        for (;;)
+        {
+            const std::size_t __begin = __state.m_next.fetch_add(__grain, std::memory_order_relaxed);
+            if (__begin >= __n || __begin >= __state.m_stop.load(std::memory_order_relaxed) || __pool.cancelled())
+            {
+                return;
+            }
+            const std::size_t __end = __grain >= __n - __begin ? __n : __begin + __grain;
+            for (std::size_t __i = __begin; __i < __end; ++__i)
+            {
+                auto __r = __step::apply(__first[static_cast<std::ranges::range_difference_t<Range>>(__i)], f);
+                if (__r.has_value()) [[likely]]
+                {
+                    if constexpr (!std::is_void_v<__value_t>)
+                    {
+                        out[__i] = *std::move(__r);
+                    }
+                }
+                else
+                {
+                    __state.fail(participant, __i, std::move(__r));
+                    break;
+                }
+            }
+        }
+    };
+
+    __pool.run(__n > __grain ? __width : 1u, __job);
+
+    if (auto *__s = __state.first_error())
+    {
+        if constexpr (std::is_void_v<__error_t>)
+        {
+            return result_t(unexpect);
+        }
+        else
+        {
+            return result_t(unexpect, std::move(*__s->error));
+        }
+    }
+    return result_t(expect);
+}
+
+template <class Range, class F>
+concept __parallel_input = std::ranges::random_access_range<Range> && std::ranges::sized_range<Range> &&
+                           requires { typename __parallel_step<std::ranges::range_reference_t<Range>, std::ranges::range_value_t<Range>, F>::type; };
+
+template <class Range, class F>
+using __parallel_result_t = typename __parallel_step<std::ranges::range_reference_t<Range>, std::ranges::range_value_t<Range>, F>::type;
+
+} // namespace detail
+
+// Applies f to every element of a random access range on the shared fork-join pool and collects
+// the results: expected<std::vector<U>, E>, or the error of the first failing element in input
+// order. Elements are expected<T, E> (f sees the value, as with transform, or and_then when f
+// returns an expected) or plain values, for which f must return expected<U, E>. The first error
+// stops the remaining chunks. Each result is written straight into its slot of the output,
+// which requires U to be default constructible; void results collect to expected<void, E>. An
+// exception thrown by f (a failed value() under the default policy, say) stops the remaining
+// chunks and is rethrown on the calling thread once all participants are done.
+template <class Range, class F>
+    requires detail::__parallel_input<Range, F>
+auto parallel_transform(const execution::parallel_policy &policy, Range &&input, F f)
+{
+    using __r_t = detail::__parallel_result_t<Range, F>;
+    using __value_t = expect_value_t<__r_t>;
+    using __error_t = expect_error_t<__r_t>;
+
+    if constexpr (std::is_void_v<__value_t>)
+    {
+        return detail::__parallel_transform_into(policy, std::forward<Range>(input), nullptr, f);
+    }
+    else
+    {
+        static_assert(std::is_default_constructible_v<__value_t>,
+                      "parallel_transform writes results into a presized vector; use the span overload otherwise");
+        using result_t = expected<std::vector<__value_t>, __error_t>;
+
+        std::vector<__value_t> __out(static_cast<std::size_t>(std::ranges::size(input)));
+        auto __done = detail::__parallel_transform_into(policy, std::forward<Range>(input), __out.data(), f);
+        if (!__done.has_value())
+        {
+            if constexpr (std::is_void_v<__error_t>)
+            {
+                return result_t(unexpect);
+            }
+            else
+            {
+                return result_t(unexpect, std::move(__done).error());
+            }
+        }
+        return result_t(std::in_place, std::move(__out));
+    }
+}
+
+// Same into caller provided storage at least as long as the input, which is checked before any
+// work starts (a shorter one fails like value() does: std::length_error by default); on error the
+// slots before the failing element hold their results and the rest are unspecified.
+template <class Range, class F, class U, std::size_t Extent>
+    requires detail::__parallel_input<Range, F> &&
+             std::is_assignable_v<U &, expect_value_t<detail::__parallel_result_t<Range, F>>>
+auto parallel_transform(const execution::parallel_policy &policy, Range &&input, std::span<U, Extent> out, F f)
+{
+    if (out.size() < static_cast<std::size_t>(std::ranges::size(input)))
+    {
+        detail::__fail_length("parallel_transform: the output is shorter than the input");
+    }
+    return detail::__parallel_transform_into(policy, std::forward<Range>(input), out.data(), f);
+}
+
+// The sequenced policy runs the same algorithm on the calling thread
+template <class Range, class F>
+    requires detail::__parallel_input<Range, F>
+auto parallel_transform(execution::sequenced_policy, Range &&input, F f)
+{
+    return parallel_transform(execution::parallel_policy{1, std::numeric_limits<std::size_t>::max()},
+                              std::forward<Range>(input), std::move(f));
+}
+
+template <class Range, class F, class U, std::size_t Extent>
+    requires detail::__parallel_input<Range, F>
+auto parallel_transform(execution::sequenced_policy, Range &&input, std::span<U, Extent> out, F f)
+{
+    return parallel_transform(execution::parallel_policy{1, std::numeric_limits<std::size_t>::max()},
+                              std::forward<Range>(input), out, std::move(f));
+}
+
+} // namespace gb
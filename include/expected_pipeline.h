@@ -0,0 +1,361 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expected_base.h"
+#include "expected_type_traits.h"
+
+namespace gb {
+
+// Fused form of the monadic operations:
+//
+//   expected<int, E> r = exp | gb::then(f) | gb::map(g) | gb::on_error(h);
+//
+// builds a lazy pipeline that is evaluated once, when it is converted to its result (or on
+// run()). The source is tested once; values then flow through the stages as plain arguments,
+// so only then() stages, which can fail, branch again. No intermediate expected is built.
+//
+//   then(f)      f(value) -> expected<U, E>, like and_then
+//   map(f)       f(value) -> U, like transform
+//   on_error(f)  f(error) -> expected<V, E> to recover or replace the error, or void to only observe it
+//
+// The pipeline refers to its source and to the stages before each |, so building it moves nothing,
+// and a last then() or on_error() stage returns the result directly: values move as often as in the
+// eager chain (see bench/pipeline_bench). Convert it in the full-expression that builds it; a
+// pipeline kept in a variable dangles. Stages are stored, and a function name would be stored as a
+// function pointer that GCC calls out of line where the eager chain inlines it, so stages take
+// lambdas or function objects: write then([](auto v) { return f(v); }) rather than then(f).
+namespace detail {
+
+enum class __stage_kind
+{
+    __then,
+    __map,
+    __on_error
+};
+
+template <__stage_kind Kind, class F>
+struct __stage
+{
+    static constexpr __stage_kind kind = Kind;
+    F f;
+};
+
+template <class T>
+struct __is_stage : std::false_type
+{
+};
+
+template <__stage_kind Kind, class F>
+struct __is_stage<__stage<Kind, F>> : std::true_type
+{
+};
+
+// the result of calling F with a value that may be void
+template <class F, class V>
+struct __call_result
+{
+    using type = std::invoke_result_t<F &, V>;
+};
+
+template <class F>
+struct __call_result<F, void>
+{
+    using type = std::invoke_result_t<F &>;
+};
+
+template <class F, class V>
+using __call_result_t = typename __call_result<F, V>::type;
+
+// value type flowing out of a stage, given the value type flowing in
+template <class V, class Stage>
+struct __stage_value
+{
+    using type = V;
+};
+
+template <class V, class F>
+struct __stage_value<V, __stage<__stage_kind::__map, F>>
+{
+    using type = std::remove_cvref_t<__call_result_t<F, V>>;
+};
+
+template <class V, class F>
+struct __stage_value<V, __stage<__stage_kind::__then, F>>
+{
+    using type = expect_value_t<__call_result_t<F, V>>;
+};
+
+template <class Prev, class Stage>
+class pipeline;
+
+// source, length and value types of a pipeline, or of the expected it starts from
+template <class P>
+struct __pipeline_traits
+{
+    using source_type = P;
+    static constexpr std::size_t size = 0;
+
+    template <std::size_t I>
+    using value_at = expect_value_t<std::remove_cvref_t<P>>;
+};
+
+template <class Prev, class Stage>
+struct __pipeline_traits<pipeline<Prev, Stage>>
+{
+    using __prev = __pipeline_traits<Prev>;
+    using source_type = typename __prev::source_type;
+    static constexpr std::size_t size = __prev::size + 1;
+
+    // value type flowing into stage I, or out of the last stage for I == size
+    template <std::size_t I>
+    using value_at = std::conditional_t<I == size,
+                                        typename __stage_value<typename __prev::template value_at<size - 1>, Stage>::type,
+                                        typename __prev::template value_at<I>>;
+};
+
+// One node per |: it refers to the pipeline before it, or to the source, and holds its own stage.
+// Nothing is moved while the pipeline is built; it must be converted in the full-expression that
+// builds it, while the source and the earlier nodes are still alive.
+template <class Prev, class Stage>
+class pipeline
+{
+    template <class, class>
+    friend class pipeline;
+
+    using __traits = __pipeline_traits<pipeline>;
+    using __source_ref_t = typename __traits::source_type &&;
+    using __source_t = std::remove_cvref_t<typename __traits::source_type>;
+    using __error_t = expect_error_t<__source_t>;
+    static constexpr std::size_t __size = __traits::size;
+
+    template <std::size_t I>
+    using __value_at_t = typename __traits::template value_at<I>;
+
+public:
+    using result_type = expected<__value_at_t<__size>, __error_t>;
+
+    constexpr pipeline(Prev &&prev, Stage &&stage) : m_prev(std::forward<Prev>(prev)), m_stage(std::move(stage)) {}
+
+    template <class F, __stage_kind Kind>
+    friend constexpr pipeline<pipeline, __stage<Kind, F>> operator|(pipeline &&p, __stage<Kind, F> s)
+    {
+        return {std::move(p), std::move(s)};
+    }
+
+    constexpr result_type run() &&
+    {
+        auto &&__exp = __source();
+        if (__exp.has_value())
+        {
+            if constexpr (std::is_void_v<expect_value_t<__source_t>>)
+            {
+                return __on_value<0>();
+            }
+            else
+            {
+                return __on_value<0>(*static_cast<__source_ref_t>(__exp));
+            }
+        }
+
+        if constexpr (std::is_void_v<__error_t>)
+        {
+            return __on_error<0>();
+        }
+        else
+        {
+            return __on_error<0>(static_cast<__source_ref_t>(__exp).error());
+        }
+    }
+
+    constexpr operator result_type() &&
+    {
+        return std::move(*this).run();
+    }
+
+private:
+    constexpr auto &__source() const noexcept
+    {
+        if constexpr (__size == 1)
+        {
+            return m_prev;
+        }
+        else
+        {
+            return m_prev.__source();
+        }
+    }
+
+    template <std::size_t I>
+    constexpr auto &__stage_at() noexcept
+    {
+        if constexpr (I + 1 == __size)
+        {
+            return m_stage;
+        }
+        else
+        {
+            return m_prev.template __stage_at<I>();
+        }
+    }
+
+    template <std::size_t I, class... V>
+    constexpr result_type __on_value(V &&...v)
+    {
+        if constexpr (I == __size)
+        {
+            if constexpr (sizeof...(V) == 0)
+            {
+                return result_type(expect);
+            }
+            else
+            {
+                return result_type(std::in_place, std::forward<V>(v)...);
+            }
+        }
+        else
+        {
+            auto &__s = __stage_at<I>();
+            using __stage_t = std::remove_cvref_t<decltype(__s)>;
+
+            if constexpr (__stage_t::kind == __stage_kind::__map)
+            {
+                if constexpr (std::is_void_v<__call_result_t<decltype(__s.f), __value_at_t<I>>>)
+                {
+                    std::invoke(__s.f, std::forward<V>(v)...);
+                    return __on_value<I + 1>();
+                }
+                else
+                {
+                    return __on_value<I + 1>(std::invoke(__s.f, std::forward<V>(v)...));
+                }
+            }
+            else if constexpr (__stage_t::kind == __stage_kind::__then)
+            {
+                using __r_t = __call_result_t<decltype(__s.f), __value_at_t<I>>;
+                static_assert(std::is_same_v<expect_error_t<__r_t>, __error_t>,
+                              "then() must return an expected with the same error type");
+                if constexpr (I + 1 == __size && std::is_same_v<__r_t, result_type>)
+                {
+                    // the last stage builds the result in place
+                    return std::invoke(__s.f, std::forward<V>(v)...);
+                }
+                else
+                {
+                    auto __r = std::invoke(__s.f, std::forward<V>(v)...);
+                    return __continue<I + 1>(std::move(__r));
+                }
+            }
+            else
+            {
+                return __on_value<I + 1>(std::forward<V>(v)...);
+            }
+        }
+    }
+
+    template <std::size_t I, class... Err>
+    constexpr result_type __on_error(Err &&...e)
+    {
+        if constexpr (I == __size)
+        {
+            return result_type(unexpect, std::forward<Err>(e)...);
+        }
+        else
+        {
+            auto &__s = __stage_at<I>();
+            using __stage_t = std::remove_cvref_t<decltype(__s)>;
+
+            if constexpr (__stage_t::kind == __stage_kind::__on_error)
+            {
+                using __r_t = std::invoke_result_t<decltype(__s.f) &, Err...>;
+                if constexpr (std::is_void_v<__r_t>)
+                {
+                    std::invoke(__s.f, std::as_const(e)...);
+                    return __on_error<I + 1>(std::forward<Err>(e)...);
+                }
+                else
+                {
+                    static_assert(std::is_same_v<std::remove_cvref_t<__r_t>, expected<__value_at_t<I>, __error_t>>,
+                                  "on_error() must return void or an expected of the current value and error types");
+                    if constexpr (I + 1 == __size && std::is_same_v<__r_t, result_type>)
+                    {
+                        return std::invoke(__s.f, std::forward<Err>(e)...);
+                    }
+                    else
+                    {
+                        return __continue<I + 1>(std::invoke(__s.f, std::forward<Err>(e)...));
+                    }
+                }
+            }
+            else
+            {
+                return __on_error<I + 1>(std::forward<Err>(e)...);
+            }
+        }
+    }
+
+    // resume at stage I from the outcome of a fallible stage
+    template <std::size_t I, class R>
+    constexpr result_type __continue(R &&r)
+    {
+        if (r.has_value())
+        {
+            if constexpr (std::is_void_v<expect_value_t<R>>)
+            {
+                return __on_value<I>();
+            }
+            else
+            {
+                return __on_value<I>(*std::forward<R>(r));
+            }
+        }
+
+        if constexpr (std::is_void_v<__error_t>)
+        {
+            return __on_error<I>();
+        }
+        else
+        {
+            return __on_error<I>(std::forward<R>(r).error());
+        }
+    }
+
+    Prev &&m_prev;
+    Stage m_stage;
+};
+
+// the source is referenced, never moved, whether it is an lvalue or an rvalue
+template <class Exp, __stage_kind Kind, class F>
+    requires is_expect_v<Exp>
+constexpr pipeline<Exp, __stage<Kind, F>> operator|(Exp &&exp, __stage<Kind, F> s)
+{
+    return {std::forward<Exp>(exp), std::move(s)};
+}
+
+} // namespace detail
+
+template <class F>
+constexpr detail::__stage<detail::__stage_kind::__then, std::decay_t<F>> then(F &&f)
+{
+    static_assert(!std::is_function_v<std::remove_reference_t<F>>, "pass a lambda, not a function name");
+    return {std::forward<F>(f)};
+}
+
+template <class F>
+constexpr detail::__stage<detail::__stage_kind::__map, std::decay_t<F>> map(F &&f)
+{
+    static_assert(!std::is_function_v<std::remove_reference_t<F>>, "pass a lambda, not a function name");
+    return {std::forward<F>(f)};
+}
+
+template <class F>
+constexpr detail::__stage<detail::__stage_kind::__on_error, std::decay_t<F>> on_error(F &&f)
+{
+    static_assert(!std::is_function_v<std::remove_reference_t<F>>, "pass a lambda, not a function name");
+    return {std::forward<F>(f)};
+}
+
+} // namespace gb
@@ -0,0 +1,631 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "expected_future.h"
+
+// Lazily started coroutine whose result is an expected<T, E>, for code that suspends (I/O, hops
+// between threads) rather than the synchronous style of expected_coroutine.h.
+//
+//   gb::task<user, errc> load_user(gb::task_pool &pool, int id)
+//   {
+//       co_await pool.schedule();                   // continue on a pool thread
+//       row r = co_await fetch_row(id);             // a task: its error finishes load_user too
+//       user u = co_await parse_user(r);            // an expected: same
+//       co_return u;
+//   }
+//
+//   gb::future<user, errc> f = gb::spawn(pool, load_user(pool, 7));
+//
+// Awaiting a task starts it and transfers control to it directly, and it transfers back the same
+// way when it finishes (symmetric transfer). That keeps long chains of awaits off the stack only
+// where the compiler emits the transfer as a tail call: GCC does at -O2, but not at -O0 or under
+// AddressSanitizer, where each level of a chain of co_await still takes a stack frame (a chain
+// 100000 deep overflows it). An error travels up by finishing the awaiting task with it: no
+// exception is thrown and the rest of the awaiting body does not run; a chain of tasks that fail
+// this way is finished in a loop, at any optimization level. Frames come from per-thread free lists
+// in a few size classes.
+//
+// An exception that escapes a task body (value() on an error under the default THROW policy, for
+// one) finishes the task too, and is rethrown from the co_await that awaited it, so it unwinds
+// through the awaiting tasks like a call stack. sync_wait() rethrows it to its caller; a spawned
+// task has no one to rethrow to, so its future is broken instead and get() fails like value() on
+// an error.
+namespace gb {
+
+template <class T, class E>
+class task;
+
+class task_pool;
+
+namespace detail {
+
+// Coroutine frames of up to 1 KiB are recycled through per-thread free lists (see
+// __block_pool); larger frames go to the heap
+struct __task_frames
+{
+    static constexpr std::size_t __align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    template <std::size_t Size>
+    using __pool = __block_pool<Size, __align>;
+
+    static void *allocate(std::size_t n)
+    {
+        if (n <= 128)
+        {
+            return __pool<128>::allocate();
+        }
+        if (n <= 256)
+        {
+            return __pool<256>::allocate();
+        }
+        if (n <= 512)
+        {
+            return __pool<512>::allocate();
+        }
+        if (n <= 1024)
+        {
+            return __pool<1024>::allocate();
+        }
+        return ::operator new(n);
+    }
+
+    static void deallocate(void *p, std::size_t n) noexcept
+    {
+        if (n <= 128)
+        {
+            __pool<128>::deallocate(p);
+        }
+        else if (n <= 256)
+        {
+            __pool<256>::deallocate(p);
+        }
+        else if (n <= 512)
+        {
+            __pool<512>::deallocate(p);
+        }
+        else if (n <= 1024)
+        {
+            __pool<1024>::deallocate(p);
+        }
+        else
+        {
+            ::operator delete(p, n);
+        }
+    }
+};
+
+template <class T, class E>
+struct __task_promise;
+
+// the part of a task's promise that finishing it walks through, whatever T and E are
+struct __task_promise_base
+{
+    std::coroutine_handle<> m_continuation;
+    std::exception_ptr m_exception;
+    bool m_failed = false; // finished with an error
+
+    // set by an awaiter that takes an error of this task as its own (see task::operator co_await):
+    // the awaiting task's promise and the function that moves the error into it
+    __task_promise_base *m_awaiting = nullptr;
+    void (*m_propagate)(__task_promise_base *) noexcept = nullptr;
+
+    // the coroutine is done: whom to run next. An error is handed up to each awaiting task that
+    // takes it here rather than through the tasks themselves, so the stack stays flat however many
+    // tasks it finishes.
+    std::coroutine_handle<> __next() noexcept
+    {
+        __task_promise_base *__p = this;
+        while (__p->m_failed && __p->m_propagate)
+        {
+            __p->m_propagate(__p);
+            __p = __p->m_awaiting;
+        }
+        if (__p->m_continuation)
+        {
+            return __p->m_continuation;
+        }
+        return std::noop_coroutine();
+    }
+};
+
+template <class P>
+struct __is_task_promise : std::false_type
+{
+};
+
+template <class T, class E>
+struct __is_task_promise<__task_promise<T, E>> : std::true_type
+{
+};
+
+// an error of Exp can finish a task whose error type is E
+template <class Exp, class E>
+concept __error_convertible_to =
+    (std::is_void_v<E> && std::is_void_v<expect_error_t<std::remove_cvref_t<Exp>>>) ||
+    (!std::is_void_v<E> && requires(Exp &&exp) { E(std::forward<Exp>(exp).error()); });
+
+// co_await on an expected inside a task: a value resumes the task with it, an error finishes the
+// task with that error
+template <class Exp, class Promise>
+struct __task_expected_awaiter
+{
+    Exp &&m_exp;
+
+    bool await_ready() const noexcept
+    {
+        return m_exp.has_value();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+    {
+        h.promise().__fail(std::forward<Exp>(m_exp));
+        return h.promise().__next();
+    }
+
+    expect_value_t<std::remove_cvref_t<Exp>> await_resume()
+    {
+        if constexpr (!std::is_void_v<expect_value_t<std::remove_cvref_t<Exp>>>)
+        {
+            return *std::forward<Exp>(m_exp);
+        }
+    }
+};
+
+template <class T, class E>
+struct __task_promise : __task_promise_base
+{
+    std::optional<expected<T, E>> m_result;
+
+    static void *operator new(std::size_t n)
+    {
+        return __task_frames::allocate(n);
+    }
+
+    static void operator delete(void *p, std::size_t n) noexcept
+    {
+        __task_frames::deallocate(p, n);
+    }
+
+    task<T, E> get_return_object() noexcept;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    struct __final_awaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<__task_promise> h) noexcept
+        {
+            return h.promise().__next();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    __final_awaiter final_suspend() const noexcept { return {}; }
+
+    // co_return value; co_return unexpected(e); co_return {}; for a void value
+    void return_value(expected<T, E> r)
+    {
+        m_failed = !r.has_value();
+        m_result.emplace(std::move(r));
+    }
+
+    // rethrown by the awaiter of this task, on whichever thread resumes it
+    void unhandled_exception() noexcept
+    {
+        m_exception = std::current_exception();
+    }
+
+    template <class Exp>
+        requires is_expect_v<std::remove_cvref_t<Exp>> && __error_convertible_to<Exp, E>
+    __task_expected_awaiter<Exp, __task_promise> await_transform(Exp &&exp) noexcept
+    {
+        return {std::forward<Exp>(exp)};
+    }
+
+    // tasks, task_pool::schedule() and other awaitables pass through unchanged
+    template <class A>
+        requires(!is_expect_v<std::remove_cvref_t<A>>)
+    A &&await_transform(A &&a) noexcept
+    {
+        return std::forward<A>(a);
+    }
+
+    template <class Exp>
+    void __fail(Exp &&exp)
+    {
+        if constexpr (std::is_void_v<E>)
+        {
+            m_result.emplace(unexpect);
+        }
+        else
+        {
+            m_result.emplace(unexpect, std::forward<Exp>(exp).error());
+        }
+        m_failed = true;
+    }
+};
+
+} // namespace detail
+
+template <class T, class E>
+class [[nodiscard]] task
+{
+public:
+    using promise_type = detail::__task_promise<T, E>;
+    using value_type = expected<T, E>;
+
+private:
+    using __handle_t = std::coroutine_handle<promise_type>;
+
+    template <bool Propagate>
+    struct __awaiter
+    {
+        __handle_t m_child;
+
+        bool await_ready() const noexcept { return false; }
+
+        template <class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept
+        {
+            auto &__child = m_child.promise();
+            __child.m_continuation = h;
+            if constexpr (Propagate)
+            {
+                static_assert(detail::__is_task_promise<P>::value,
+                              "co_await on a task yields its value only inside a task; use result() elsewhere");
+                __child.m_awaiting = &h.promise();
+                __child.m_propagate = &__propagate<P>;
+            }
+            return m_child;
+        }
+
+        auto await_resume()
+        {
+            if (m_child.promise().m_exception)
+            {
+                std::rethrow_exception(m_child.promise().m_exception);
+            }
+            auto &__r = *m_child.promise().m_result;
+            if constexpr (!Propagate)
+            {
+                return std::move(__r);
+            }
+            else if constexpr (!std::is_void_v<T>)
+            {
+                return T(*std::move(__r));
+            }
+        }
+
+        template <class P>
+        static void __propagate(detail::__task_promise_base *child) noexcept
+        {
+            auto &__c = static_cast<promise_type &>(*child);
+            static_cast<P &>(*__c.m_awaiting).__fail(std::move(*__c.m_result));
+        }
+    };
+
+public:
+    task() noexcept = default;
+
+    explicit task(__handle_t h) noexcept
+        : m_handle(h)
+    {
+    }
+
+    task(task &&other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr))
+    {
+    }
+
+    task &operator=(task &&other) noexcept
+    {
+        task(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+
+    ~task()
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+
+    void swap(task &other) noexcept
+    {
+        std::swap(m_handle, other.m_handle);
+    }
+
+    bool valid() const noexcept { return static_cast<bool>(m_handle); }
+
+    // Inside a task: runs this task and yields its value; its error finishes the awaiting task
+    // with that error. The awaiting task's error type must be constructible from E.
+    __awaiter<true> operator co_await() && noexcept
+    {
+        return {m_handle};
+    }
+
+    // co_await std::move(t).result() runs this task and yields its expected<T, E> as is
+    __awaiter<false> result() && noexcept
+    {
+        return {m_handle};
+    }
+
+private:
+    __handle_t m_handle;
+};
+
+template <class T, class E>
+task<T, E> detail::__task_promise<T, E>::get_return_object() noexcept
+{
+    return task<T, E>(std::coroutine_handle<__task_promise>::from_promise(*this));
+}
+
+// Work-stealing pool for coroutines. Every thread owns a deque: it pushes and pops the work it
+// schedules itself at the back, so a chain of hops stays warm in one cache, while idle threads
+// steal from the front of the others'. Work posted from outside the pool is spread round robin.
+// Idle threads sleep on one atomic word and are only notified when some are asleep.
+class task_pool
+{
+public:
+    explicit task_pool(unsigned threads = std::max(1u, std::thread::hardware_concurrency()))
+        : m_queues(std::max(1u, threads))
+    {
+        m_threads.reserve(m_queues.size());
+        for (unsigned __i = 0; __i < m_queues.size(); ++__i)
+        {
+            m_threads.emplace_back([this, __i] { __worker(__i); });
+        }
+    }
+
+    // work still queued runs to completion first
+    ~task_pool()
+    {
+        m_stop.store(true, std::memory_order_release);
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        m_epoch.notify_all();
+        for (auto &__t : m_threads)
+        {
+            __t.join();
+        }
+    }
+
+    task_pool(const task_pool &) = delete;
+    task_pool &operator=(const task_pool &) = delete;
+
+    static task_pool &shared()
+    {
+        static task_pool __pool;
+        return __pool;
+    }
+
+    unsigned size() const noexcept
+    {
+        return static_cast<unsigned>(m_threads.size());
+    }
+
+    struct __schedule_awaiter
+    {
+        task_pool *m_pool;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { m_pool->post(h); }
+        void await_resume() const noexcept {}
+    };
+
+    // co_await pool.schedule() continues the coroutine on a thread of the pool
+    __schedule_awaiter schedule() noexcept
+    {
+        return {this};
+    }
+
+    void post(std::coroutine_handle<> h)
+    {
+        const auto &__self = __current();
+        const std::size_t __q = __self.m_pool == this
+                                    ? __self.m_index
+                                    : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+        {
+            std::lock_guard __lock(m_queues[__q].m_mutex);
+            m_queues[__q].m_items.push_back(h);
+        }
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_seq_cst))
+        {
+            m_epoch.notify_one();
+        }
+    }
+
+private:
+    struct alignas(64) __queue
+    {
+        std::mutex m_mutex;
+        std::deque<std::coroutine_handle<>> m_items;
+    };
+
+    struct __worker_id
+    {
+        task_pool *m_pool = nullptr;
+        std::size_t m_index = 0;
+    };
+
+    static __worker_id &__current() noexcept
+    {
+        thread_local __worker_id __id;
+        return __id;
+    }
+
+    // own queue from the back, then the others from the front
+    std::coroutine_handle<> __find(std::size_t self)
+    {
+        {
+            auto &__own = m_queues[self];
+            std::lock_guard __lock(__own.m_mutex);
+            if (!__own.m_items.empty())
+            {
+                auto __h = __own.m_items.back();
+                __own.m_items.pop_back();
+                return __h;
+            }
+        }
+        for (std::size_t __i = 1; __i < m_queues.size(); ++__i)
+        {
+            auto &__victim = m_queues[(self + __i) % m_queues.size()];
+            std::unique_lock __lock(__victim.m_mutex, std::try_to_lock);
+            if (__lock && !__victim.m_items.empty())
+            {
+                auto __h = __victim.m_items.front();
+                __victim.m_items.pop_front();
+                return __h;
+            }
+        }
+        return nullptr;
+    }
+
+    bool __any_queued()
+    {
+        for (auto &__q : m_queues)
+        {
+            std::lock_guard __lock(__q.m_mutex);
+            if (!__q.m_items.empty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void __worker(std::size_t index)
+    {
+        __current() = {this, index};
+        for (;;)
+        {
+            const std::uint32_t __epoch = m_epoch.load(std::memory_order_seq_cst);
+            if (auto __h = __find(index))
+            {
+                __h.resume();
+                continue;
+            }
+            // a steal that lost a try_lock race must not put the thread to sleep with work queued
+            if (__any_queued())
+            {
+                continue;
+            }
+            if (m_stop.load(std::memory_order_acquire))
+            {
+                return;
+            }
+            // a post after the epoch was read changes it, so the wait returns at once
+            m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+            m_epoch.wait(__epoch, std::memory_order_seq_cst);
+            m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<__queue> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::uint32_t> m_epoch{0};
+    std::atomic<std::uint32_t> m_sleeping{0};
+    std::atomic<std::size_t> m_next{0};
+    std::atomic<bool> m_stop{false};
+};
+
+namespace detail {
+
+// fire-and-forget coroutine that owns a task and hands its result to a promise; an exception
+// from the task goes to *exception if given, and breaks the promise
+struct __detached_task
+{
+    struct promise_type
+    {
+        static void *operator new(std::size_t n)
+        {
+            return __task_frames::allocate(n);
+        }
+
+        static void operator delete(void *p, std::size_t n) noexcept
+        {
+            __task_frames::deallocate(p, n);
+        }
+
+        __detached_task get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+template <class T, class E>
+__detached_task __run_task(task<T, E> t, promise<T, E> p, task_pool *pool, std::exception_ptr *exception)
+{
+    if (pool)
+    {
+        co_await pool->schedule();
+    }
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+    try
+    {
+        p.set(co_await std::move(t).result());
+    }
+    catch (...)
+    {
+        if (exception)
+        {
+            *exception = std::current_exception();
+        }
+    }
+#else
+    (void)exception;
+    p.set(co_await std::move(t).result());
+#endif
+}
+
+} // namespace detail
+
+// Starts t on a thread of pool; the future settles with its result, or is broken if t throws
+template <class T, class E>
+future<T, E> spawn(task_pool &pool, task<T, E> t)
+{
+    promise<T, E> __p;
+    auto __f = __p.get_future();
+    detail::__run_task(std::move(t), std::move(__p), &pool, nullptr);
+    return __f;
+}
+
+// Runs t on the calling thread up to its first hop elsewhere, then blocks until it finishes;
+// an exception thrown out of t is rethrown here
+template <class T, class E>
+expected<T, E> sync_wait(task<T, E> t)
+{
+    promise<T, E> __p;
+    auto __f = __p.get_future();
+    std::exception_ptr __exception;
+    detail::__run_task(std::move(t), std::move(__p), nullptr, &__exception);
+    __f.wait();
+    if (__exception)
+    {
+        std::rethrow_exception(__exception);
+    }
+    return std::move(__f).get();
+}
+
+} // namespace gb
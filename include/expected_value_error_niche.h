@@ -0,0 +1,442 @@
+#pragma once
+#include <bit>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "expected_base.h"
+#include "expected_monadic_operations.h"
+#include "expected_niche.h"
+
+
+namespace gb
+{
+// T declares a free low bit through niche_traits and E is small enough to be packed above it:
+// the whole expected is a single word, with no separate discriminant.
+//
+// The error is kept as bits of that word, not as an E object, so error() returns a copy from
+// every overload. Unlike the other specializations, it cannot be assigned through (for a class E,
+// r.error() = x assigns a temporary), or_else and transform_error pass f a prvalue (f may take E,
+// const E & or E &&, but not E &), and std::move(r).error() is a copy. That is why packing is
+// limited to trivially copyable E smaller than T (detail::niche_packable), for which a copy is as
+// cheap as a reference; to change the error of a packed expected, assign it an unexpected.
+template <class T, class E>
+    requires(!std::is_void_v<T>) && (!std::is_void_v<E>) && detail::niche_packable<T, E>
+struct expected<T, E>
+{
+
+    #pragma region constructors
+
+    #pragma region default empty/copy/move constructors
+
+    constexpr expected() noexcept(std::is_nothrow_default_constructible_v<T>) // strengthened
+        requires std::is_default_constructible_v<T>
+    {
+        std::construct_at(std::addressof(m_value_error.m_value));
+    }
+
+    constexpr expected(unexpect_t GB_EXPECTED_TRACE_PARAM) noexcept(std::is_nothrow_default_constructible_v<E>) // strengthened
+        requires std::is_default_constructible_v<E>
+    {
+        GB_EXPECTED_TRACE(created);
+        __set_error(E());
+    }
+
+    // T and E are trivially copyable, so are we
+    constexpr expected(const expected &) = default;
+    constexpr expected(expected &&) = default;
+
+    #pragma endregion
+
+    #pragma region conversion constructors
+
+    template <class _Up, class _OtherErr>
+        requires detail::can_convert<T, E, _Up, _OtherErr, const _Up &, const _OtherErr &>::value
+    constexpr explicit(!std::is_convertible_v<const _Up &, T> || !std::is_convertible_v<const _OtherErr &, E>)
+        expected(const expected<_Up, _OtherErr> &other) noexcept(std::is_nothrow_constructible_v<T, const _Up &> &&
+                                                                 std::is_nothrow_constructible_v<E, const _OtherErr &>) // strengthened
+    {
+        if (other.has_value())
+        {
+            std::construct_at(std::addressof(m_value_error.m_value), *other);
+        }
+        else
+        {
+            __set_error(E(other.error()));
+        }
+    }
+
+    template <class _Up, class _OtherErr>
+        requires detail::can_convert<T, E, _Up, _OtherErr, _Up, _OtherErr>::value
+    constexpr explicit(!std::is_convertible_v<_Up, T> || !std::is_convertible_v<_OtherErr, E>)
+        expected(expected<_Up, _OtherErr> &&other) noexcept(std::is_nothrow_constructible_v<T, _Up> &&std::is_nothrow_constructible_v<E, _OtherErr>) // strengthened
+    {
+        if (other.has_value())
+        {
+            std::construct_at(std::addressof(m_value_error.m_value), *std::move(other));
+        }
+        else
+        {
+            __set_error(E(std::move(other).error()));
+        }
+    }
+
+    #pragma endregion
+
+    template <class _Up = T>
+        requires(!std::is_same_v<std::remove_cvref_t<_Up>, std::in_place_t> && !std::is_same_v<expected, std::remove_cvref_t<_Up>> &&
+                 !is_unexpect_v<std::remove_cvref_t<_Up>> && std::is_constructible_v<T, _Up>)
+    constexpr explicit(!std::is_convertible_v<_Up, T>)
+        expected(_Up &&__u) noexcept(std::is_nothrow_constructible_v<T, _Up>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Up>(__u));
+    }
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, const _OtherErr &>
+    constexpr explicit(!std::is_convertible_v<const _OtherErr &, E>)
+        expected(const unexpected<_OtherErr> &err) noexcept(std::is_nothrow_constructible_v<E, const _OtherErr &>) // strengthened
+    {
+        __set_error(E(err.error()));
+    }
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, _OtherErr>
+    constexpr explicit(!std::is_convertible_v<_OtherErr, E>)
+        expected(unexpected<_OtherErr> &&err) noexcept(std::is_nothrow_constructible_v<E, _OtherErr>) // strengthened
+    {
+        __set_error(E(std::move(err.error())));
+    }
+
+    template <class... _Args>
+        requires std::is_constructible_v<T, _Args...>
+    constexpr explicit expected(std::in_place_t, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<T, _Args...>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Args>(__args)...);
+    }
+
+    template <class _Up, class... _Args>
+        requires std::is_constructible_v<T, std::initializer_list<_Up> &, _Args...>
+    constexpr explicit expected(std::in_place_t, std::initializer_list<_Up> __il, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<_Up> &, _Args...>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_value), __il, std::forward<_Args>(__args)...);
+    }
+
+    template <class... _Args>
+        requires std::is_constructible_v<E, _Args...>
+    constexpr explicit expected(detail::__unexpect_at __tag, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, _Args...>) // strengthened
+    {
+        GB_EXPECTED_TRACE_UNEXPECT(__tag);
+        __set_error(E(std::forward<_Args>(__args)...));
+    }
+
+    template <class _Up, class... _Args>
+        requires std::is_constructible_v<E, std::initializer_list<_Up> &, _Args...>
+    constexpr explicit expected(detail::__unexpect_at __tag, std::initializer_list<_Up> __il, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<_Up> &, _Args...>) // strengthened
+    {
+        GB_EXPECTED_TRACE_UNEXPECT(__tag);
+        __set_error(E(__il, std::forward<_Args>(__args)...));
+    }
+
+    #pragma endregion
+
+    #pragma region destructors
+
+    constexpr ~expected() = default;
+
+    #pragma endregion
+
+    #pragma region assignments
+
+    constexpr expected &operator=(const expected &) = default;
+    constexpr expected &operator=(expected &&) = default;
+
+    template <class _Up = T>
+    constexpr expected &operator=(_Up &&__v)
+        requires(!std::is_same_v<expected, std::remove_cvref_t<_Up>> &&
+                 !is_unexpect_v<std::remove_cvref_t<_Up>> &&
+                 std::is_constructible_v<T, _Up> &&
+                 std::is_assignable_v<T &, _Up>)
+    {
+        if (has_value())
+        {
+            m_value_error.m_value = std::forward<_Up>(__v);
+        }
+        else
+        {
+            std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Up>(__v));
+        }
+        return *this;
+    }
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, const _OtherErr &>
+    constexpr expected &operator=(const unexpected<_OtherErr> &__un)
+    {
+        __set_error(E(__un.error()));
+        return *this;
+    }
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, _OtherErr>
+    constexpr expected &operator=(unexpected<_OtherErr> &&__un)
+    {
+        __set_error(E(std::move(__un.error())));
+        return *this;
+    }
+
+    #pragma endregion
+
+    #pragma region emplace
+
+    template <class... _Args>
+        requires std::is_nothrow_constructible_v<T, _Args...>
+    constexpr T &emplace(_Args &&...__args) noexcept
+    {
+        return *std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Args>(__args)...);
+    }
+
+    template <class _Up, class... _Args>
+        requires std::is_nothrow_constructible_v<T, std::initializer_list<_Up> &, _Args...>
+    constexpr T &emplace(std::initializer_list<_Up> __il, _Args &&...__args) noexcept
+    {
+        return *std::construct_at(std::addressof(m_value_error.m_value), __il, std::forward<_Args>(__args)...);
+    }
+
+    #pragma endregion
+
+    #pragma region swap
+
+    constexpr void swap(expected &__rhs) noexcept
+    {
+        std::swap(m_value_error, __rhs.m_value_error);
+    }
+
+    friend constexpr void swap(expected &__x, expected &__y) noexcept
+    {
+        __x.swap(__y);
+    }
+
+    #pragma endregion
+
+    // always present methods
+    explicit operator bool() const noexcept { return has_value(); }
+
+    bool has_value() const noexcept { return (std::bit_cast<__word_t>(m_value_error) & detail::niche_tag) == 0; }
+
+    // only for E not void
+    // a copy, see the top of this file
+    constexpr E error() const noexcept
+    {
+        return detail::niche_unpack<E>(m_value_error.m_word);
+    }
+
+    // only for T not void
+    constexpr const T *operator->() const noexcept
+    {
+        return std::addressof(m_value_error.m_value);
+    }
+
+    constexpr T *operator->() noexcept
+    {
+        return std::addressof(m_value_error.m_value);
+    }
+
+    constexpr T &operator*() & noexcept
+    {
+        return m_value_error.m_value;
+    }
+
+    constexpr T &&operator*() && noexcept
+    {
+        return std::move(m_value_error.m_value);
+    }
+
+    constexpr const T &operator*() const & noexcept
+    {
+        return m_value_error.m_value;
+    }
+
+    constexpr const T &&operator*() const && noexcept
+    {
+        return std::move(m_value_error.m_value);
+    }
+
+    constexpr T &value() &
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(error());
+        return m_value_error.m_value;
+    }
+
+    constexpr T &&value() &&
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(error());
+        return std::move(m_value_error.m_value);
+    }
+
+    constexpr const T &value() const &
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(error());
+        return m_value_error.m_value;
+    }
+
+    constexpr const T &&value() const &&
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(error());
+        return std::move(m_value_error.m_value);
+    }
+
+    template <class U>
+    constexpr T value_or(U &&default_value) const & noexcept
+    {
+        return has_value() ? **this : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    template <class U>
+    constexpr T value_or(U &&default_value) && noexcept
+    {
+        return has_value() ? std::move(**this) : static_cast<T>(std::forward<U>(default_value));
+    }
+
+#pragma region Monadic operations
+
+#pragma region and_then
+    // and_then
+    template <class F>
+        requires std::is_invocable_v<F, T> && (is_expect_v<std::invoke_result_t<F, T>> || std::is_same_v<std::invoke_result_t<F, T>, T>)
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) const &
+    {
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) const &&
+    {
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+#pragma endregion
+
+#pragma region transform
+
+    // transform
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) const &
+    {
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) const &&
+    {
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+#pragma endregion
+
+#pragma region or_else
+
+    // transform
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) const &
+    {
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) const &&
+    {
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+#pragma endregion
+
+#pragma region transform_error
+
+    // transform error
+    template <class F>
+    constexpr auto transform_error(F &&f) &
+    {
+        return detail::transform_error_impl(*this, std::forward<F>(f));
+    }
+
+    template <class F>
+    constexpr auto transform_error(F &&f) const &
+    {
+        return detail::transform_error_impl(*this, std::forward<F>(f));
+    }
+
+    template <class F>
+    constexpr auto transform_error(F &&f) &&
+    {
+        return detail::transform_error_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    template <class F>
+    constexpr auto transform_error(F &&f) const &&
+    {
+        return detail::transform_error_impl(std::move(*this), std::forward<F>(f));
+    }
+
+#pragma endregion
+
+#pragma endregion
+
+private:
+    using __word_t = detail::niche_word_t<T>;
+
+    constexpr void __set_error(const E &__e) noexcept
+    {
+        m_value_error.m_word = detail::niche_pack<__word_t>(__e);
+    }
+
+    union __union_t
+    {
+        constexpr __union_t() : m_word() {}
+
+        T m_value;
+        __word_t m_word;
+    } m_value_error;
+};
+}
@@ -1,12 +1,16 @@
 #pragma once
+#include <initializer_list>
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include "expected_base.h"
 #include "expected_monadic_operations.h"
+#include "expected_niche.h"
 
 namespace gb{
 
 template<class T, class E>
-requires (!std::is_void_v<T>) && (std::is_void_v<E>)
+requires (!std::is_void_v<T>) && (std::is_void_v<E>) && (!detail::has_niche<T>)
 struct expected<T,E>
 {
 
@@ -21,9 +25,11 @@ struct expected<T,E>
         std::construct_at(std::addressof(m_value_error.m_value));
     }
 
-    constexpr expected(unexpect_t) noexcept // strengthened
+    constexpr expected(unexpect_t GB_EXPECTED_TRACE_PARAM) noexcept // strengthened
         : m_has_value(false)
-    {}
+    {
+        GB_EXPECTED_TRACE(created);
+    }
 
     constexpr expected(const expected &) = delete;
 
@@ -64,11 +70,11 @@ struct expected<T,E>
         requires detail::can_convert_void_error<T, _Up, const _Up &>::value
     constexpr explicit(!std::is_convertible_v<const _Up &, T>)
         expected(const expected<_Up, void> &other) noexcept(std::is_nothrow_constructible_v<T, const _Up &>) // strengthened
-        : m_has_value(other.m_has_value)
+        : m_has_value(other.has_value())
     {
         if (m_has_value)
         {
-            std::construct_at(std::addressof(m_value_error.m_value), other.m_value_error.m_value);
+            std::construct_at(std::addressof(m_value_error.m_value), *other);
         }
     }
 
@@ -76,11 +82,11 @@ struct expected<T,E>
         requires detail::can_convert_void_error<T, _Up, _Up>::value
     constexpr explicit(!std::is_convertible_v<_Up, T>)
         expected(expected<_Up, void> &&other) noexcept(std::is_nothrow_constructible_v<T, _Up>) // strengthened
-        : m_has_value(other.m_has_value)
+        : m_has_value(other.has_value())
     {
         if (m_has_value)
         {
-            std::construct_at(std::addressof(m_value_error.m_value), std::move(other.m_value_error.m_value));
+            std::construct_at(std::addressof(m_value_error.m_value), *std::move(other));
         }
     }
 
@@ -117,11 +123,11 @@ struct expected<T,E>
     #pragma region destructors
 
     constexpr ~expected()
-        requires(std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>)
+        requires std::is_trivially_destructible_v<T>
     = default;
 
     constexpr ~expected()
-        requires(!std::is_trivially_destructible_v<T> || !std::is_trivially_destructible_v<E>)
+        requires(!std::is_trivially_destructible_v<T>)
     {
         if (m_has_value)
         {
@@ -163,10 +169,17 @@ private:
 public:
     constexpr expected &operator=(const expected &) = delete;
 
+    constexpr expected &operator=(const expected &)
+        requires(std::is_trivially_copy_assignable_v<T> &&
+                 std::is_trivially_copy_constructible_v<T> &&
+                 std::is_trivially_destructible_v<T>)
+    = default;
+
     constexpr expected &operator=(const expected &__rhs) noexcept(std::is_nothrow_copy_assignable_v<T> &&
                                                                   std::is_nothrow_copy_constructible_v<T>) // strengthened
         requires(std::is_copy_assignable_v<T> &&
-                 std::is_copy_constructible_v<T>)
+                 std::is_copy_constructible_v<T> &&
+                 !(std::is_trivially_copy_assignable_v<T> && std::is_trivially_copy_constructible_v<T> && std::is_trivially_destructible_v<T>))
     {
         if (m_has_value && __rhs.m_has_value)
         {
@@ -185,10 +198,17 @@ public:
         return *this;
     }
 
+    constexpr expected &operator=(expected &&)
+        requires(std::is_trivially_move_assignable_v<T> &&
+                 std::is_trivially_move_constructible_v<T> &&
+                 std::is_trivially_destructible_v<T>)
+    = default;
+
     constexpr expected &operator=(expected &&__rhs) noexcept(std::is_nothrow_move_assignable_v<T> &&
                                                              std::is_nothrow_move_constructible_v<T>)
         requires(std::is_move_constructible_v<T> &&
-                 std::is_move_assignable_v<T>)
+                 std::is_move_assignable_v<T> &&
+                 !(std::is_trivially_move_assignable_v<T> && std::is_trivially_move_constructible_v<T> && std::is_trivially_destructible_v<T>))
     {
         if (m_has_value && __rhs.m_has_value)
         {
@@ -217,7 +237,7 @@ public:
     {
         if (m_has_value)
         {
-            m_value_error.__val_ = std::forward<_Up>(__v);
+            m_value_error.m_value = std::forward<_Up>(__v);
         }
         else
         {
@@ -316,7 +336,7 @@ public:
     #pragma endregion
 
     //always present methods
-    operator bool() const noexcept { return m_has_value; }
+    explicit operator bool() const noexcept { return m_has_value; }
 
     bool has_value() const noexcept { return m_has_value; }
 
@@ -371,28 +391,28 @@ public:
     constexpr T &value() &
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>();
+            detail::__fail_bad_expect_access();
         return m_value_error.m_value;
     }
 
     constexpr T &&value() &&
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>();
+            detail::__fail_bad_expect_access();
         return std::move(m_value_error.m_value);
     }
 
     constexpr const T &value() const &
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>();
+            detail::__fail_bad_expect_access();
         return m_value_error.m_value;
     }
 
     constexpr const T &&value() const &&
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>();
+            detail::__fail_bad_expect_access();
         return std::move(m_value_error.m_value);
     }
 
@@ -414,27 +434,27 @@ public:
     //and_then
     template<class F>
         requires std::is_invocable_v<F, T> && (is_expect_v<std::invoke_result_t<F, T>> || std::is_same_v<std::invoke_result_t<F, T>, T>)
-    constexpr auto and_then( F&& f ) &
+    constexpr auto and_then( F&& f GB_EXPECTED_TRACE_PARAM) &
     {
-        return detail::and_then_impl(*this, std::forward<F>(f));
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto and_then(F&& f) const&
+    constexpr auto and_then(F&& f GB_EXPECTED_TRACE_PARAM) const&
     {
-        return detail::and_then_impl(*this, std::forward<F>(f));
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto and_then( F&& f) &&
+    constexpr auto and_then( F&& f GB_EXPECTED_TRACE_PARAM) &&
     {
-        return detail::and_then_impl(std::move(*this), std::forward<F>(f));
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto and_then( F&& f) const&&
+    constexpr auto and_then( F&& f GB_EXPECTED_TRACE_PARAM) const&&
     {
-        return detail::and_then_impl(std::move(*this), std::forward<F>(f));
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     #pragma endregion
@@ -443,27 +463,27 @@ public:
 
     //transform
     template<class F>
-    constexpr auto transform( F&& f ) &
+    constexpr auto transform( F&& f GB_EXPECTED_TRACE_PARAM) &
     {
-        return detail::transform_impl(*this, std::forward<F>(f));
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto transform(F&& f) const&
+    constexpr auto transform(F&& f GB_EXPECTED_TRACE_PARAM) const&
     {
-        return detail::transform_impl(*this, std::forward<F>(f));
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto transform( F&& f) &&
+    constexpr auto transform( F&& f GB_EXPECTED_TRACE_PARAM) &&
     {
-        return detail::transform_impl(std::move(*this), std::forward<F>(f));
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto transform( F&& f) const&&
+    constexpr auto transform( F&& f GB_EXPECTED_TRACE_PARAM) const&&
     {
-        return detail::transform_impl(std::move(*this), std::forward<F>(f));
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
 
@@ -473,27 +493,27 @@ public:
 
     //transform
     template<class F>
-    constexpr auto or_else( F&& f ) &
+    constexpr auto or_else( F&& f GB_EXPECTED_TRACE_PARAM) &
     {
-        return detail::or_else_impl(*this, std::forward<F>(f));
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto or_else(F&& f) const&
+    constexpr auto or_else(F&& f GB_EXPECTED_TRACE_PARAM) const&
     {
-        return detail::or_else_impl(*this, std::forward<F>(f));
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto or_else( F&& f) &&
+    constexpr auto or_else( F&& f GB_EXPECTED_TRACE_PARAM) &&
     {
-        return detail::or_else_impl(std::move(*this), std::forward<F>(f));
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template<class F>
-    constexpr auto or_else( F&& f) const&&
+    constexpr auto or_else( F&& f GB_EXPECTED_TRACE_PARAM) const&&
     {
-        return detail::or_else_impl(std::move(*this), std::forward<F>(f));
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     #pragma endregion
@@ -542,12 +562,12 @@ private:
         constexpr __union_t() : __empty_() {}
 
         constexpr ~__union_t()
-            requires(std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>)
+            requires std::is_trivially_destructible_v<T>
         = default;
 
         // the expected's destructor handles this
         constexpr ~__union_t()
-            requires(!std::is_trivially_destructible_v<T> || !std::is_trivially_destructible_v<E>)
+            requires(!std::is_trivially_destructible_v<T>)
         {
         }
 
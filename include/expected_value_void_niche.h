@@ -0,0 +1,391 @@
+#pragma once
+#include <bit>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "expected_base.h"
+#include "expected_monadic_operations.h"
+#include "expected_niche.h"
+
+namespace gb{
+
+// T declares a free low bit through niche_traits: the empty state is a word with that bit set,
+// so the expected is exactly sizeof(T).
+template<class T, class E>
+requires (!std::is_void_v<T>) && (std::is_void_v<E>) && detail::has_niche<T>
+struct expected<T,E>
+{
+
+    #pragma region constructors
+
+    #pragma region default empty/copy/move constructors
+
+    constexpr expected() noexcept(std::is_nothrow_default_constructible_v<T>) // strengthened
+        requires std::is_default_constructible_v<T>
+    {
+        std::construct_at(std::addressof(m_value_error.m_value));
+    }
+
+    constexpr expected(unexpect_t GB_EXPECTED_TRACE_PARAM) noexcept // strengthened
+    {
+        GB_EXPECTED_TRACE(created);
+        m_value_error.m_word = detail::niche_tag;
+    }
+
+    // T is trivially copyable, so are we
+    constexpr expected(const expected &) = default;
+    constexpr expected(expected &&) = default;
+
+    #pragma endregion
+
+    #pragma region conversion constructors
+
+    template <class _Up>
+        requires detail::can_convert_void_error<T, _Up, const _Up &>::value
+    constexpr explicit(!std::is_convertible_v<const _Up &, T>)
+        expected(const expected<_Up, void> &other) noexcept(std::is_nothrow_constructible_v<T, const _Up &>) // strengthened
+    {
+        if (other.has_value())
+        {
+            std::construct_at(std::addressof(m_value_error.m_value), *other);
+        }
+        else
+        {
+            m_value_error.m_word = detail::niche_tag;
+        }
+    }
+
+    template <class _Up>
+        requires detail::can_convert_void_error<T, _Up, _Up>::value
+    constexpr explicit(!std::is_convertible_v<_Up, T>)
+        expected(expected<_Up, void> &&other) noexcept(std::is_nothrow_constructible_v<T, _Up>) // strengthened
+    {
+        if (other.has_value())
+        {
+            std::construct_at(std::addressof(m_value_error.m_value), *std::move(other));
+        }
+        else
+        {
+            m_value_error.m_word = detail::niche_tag;
+        }
+    }
+
+    #pragma endregion
+
+    template <class _Up = T>
+        requires(!std::is_same_v<std::remove_cvref_t<_Up>, std::in_place_t> && !std::is_same_v<expected, std::remove_cvref_t<_Up>> &&
+                 !is_unexpect_v<std::remove_cvref_t<_Up>> && std::is_constructible_v<T, _Up>)
+    constexpr explicit(!std::is_convertible_v<_Up, T>)
+        expected(_Up &&__u) noexcept(std::is_nothrow_constructible_v<T, _Up>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Up>(__u));
+    }
+
+    template <class... _Args>
+        requires std::is_constructible_v<T, _Args...>
+    constexpr explicit expected(std::in_place_t, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<T, _Args...>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Args>(__args)...);
+    }
+
+    template <class _Up, class... _Args>
+        requires std::is_constructible_v<T, std::initializer_list<_Up> &, _Args...>
+    constexpr explicit expected(std::in_place_t, std::initializer_list<_Up> __il, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<T, std::initializer_list<_Up> &, _Args...>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_value), __il, std::forward<_Args>(__args)...);
+    }
+
+    #pragma endregion
+
+    #pragma region destructors
+
+    constexpr ~expected() = default;
+
+    #pragma endregion
+
+    #pragma region assignments
+
+    constexpr expected &operator=(const expected &) = default;
+    constexpr expected &operator=(expected &&) = default;
+
+    template <class _Up = T>
+    constexpr expected &operator=(_Up &&__v)
+        requires(!std::is_same_v<expected, std::remove_cvref_t<_Up>> &&
+                 !is_unexpect_v<std::remove_cvref_t<_Up>> &&
+                 std::is_constructible_v<T, _Up> &&
+                 std::is_assignable_v<T &, _Up>)
+    {
+        if (has_value())
+        {
+            m_value_error.m_value = std::forward<_Up>(__v);
+        }
+        else
+        {
+            std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Up>(__v));
+        }
+        return *this;
+    }
+
+    #pragma endregion
+
+    #pragma region emplace
+
+    template <class... _Args>
+        requires std::is_nothrow_constructible_v<T, _Args...>
+    constexpr T &emplace(_Args &&...__args) noexcept
+    {
+        return *std::construct_at(std::addressof(m_value_error.m_value), std::forward<_Args>(__args)...);
+    }
+
+    template <class _Up, class... _Args>
+        requires std::is_nothrow_constructible_v<T, std::initializer_list<_Up> &, _Args...>
+    constexpr T &emplace(std::initializer_list<_Up> __il, _Args &&...__args) noexcept
+    {
+        return *std::construct_at(std::addressof(m_value_error.m_value), __il, std::forward<_Args>(__args)...);
+    }
+
+    #pragma endregion
+
+    #pragma region swap
+
+    constexpr void swap(expected &__rhs) noexcept
+    {
+        std::swap(m_value_error, __rhs.m_value_error);
+    }
+
+    friend constexpr void swap(expected &__x, expected &__y) noexcept
+    {
+        __x.swap(__y);
+    }
+
+    #pragma endregion
+
+    //always present methods
+    explicit operator bool() const noexcept { return has_value(); }
+
+    bool has_value() const noexcept { return (std::bit_cast<__word_t>(m_value_error) & detail::niche_tag) == 0; }
+
+    //only for E not void
+    constexpr void error() const& noexcept
+    {
+    }
+
+    constexpr void error() & noexcept
+    {
+    }
+
+    constexpr void error() const&& noexcept
+    {
+    }
+
+    constexpr void error() && noexcept
+    {
+    }
+
+    // only for T not void
+    constexpr const T *operator->() const noexcept
+    {
+        return std::addressof(m_value_error.m_value);
+    }
+
+    constexpr T *operator->() noexcept
+    {
+        return std::addressof(m_value_error.m_value);
+    }
+
+    constexpr T &operator*() & noexcept
+    {
+        return m_value_error.m_value;
+    }
+
+    constexpr T &&operator*() && noexcept
+    {
+        return std::move(m_value_error.m_value);
+    }
+
+    constexpr const T &operator*() const & noexcept
+    {
+        return m_value_error.m_value;
+    }
+
+    constexpr const T &&operator*() const && noexcept
+    {
+        return std::move(m_value_error.m_value);
+    }
+
+    constexpr T &value() &
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access();
+        return m_value_error.m_value;
+    }
+
+    constexpr T &&value() &&
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access();
+        return std::move(m_value_error.m_value);
+    }
+
+    constexpr const T &value() const &
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access();
+        return m_value_error.m_value;
+    }
+
+    constexpr const T &&value() const &&
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access();
+        return std::move(m_value_error.m_value);
+    }
+
+    template <class U>
+    constexpr T value_or(U &&default_value) const & noexcept
+    {
+        return has_value() ? **this : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    template <class U>
+    constexpr T value_or(U &&default_value) && noexcept
+    {
+        return has_value() ? std::move(**this) : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    #pragma region Monadic operations
+
+    #pragma region and_then
+    //and_then
+    template<class F>
+        requires std::is_invocable_v<F, T> && (is_expect_v<std::invoke_result_t<F, T>> || std::is_same_v<std::invoke_result_t<F, T>, T>)
+    constexpr auto and_then( F&& f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto and_then(F&& f GB_EXPECTED_TRACE_PARAM) const&
+    {
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto and_then( F&& f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto and_then( F&& f GB_EXPECTED_TRACE_PARAM) const&&
+    {
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    #pragma endregion
+
+    #pragma region transform
+
+    //transform
+    template<class F>
+    constexpr auto transform( F&& f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto transform(F&& f GB_EXPECTED_TRACE_PARAM) const&
+    {
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto transform( F&& f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto transform( F&& f GB_EXPECTED_TRACE_PARAM) const&&
+    {
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+
+    #pragma endregion
+
+    #pragma region or_else
+
+    //transform
+    template<class F>
+    constexpr auto or_else( F&& f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto or_else(F&& f GB_EXPECTED_TRACE_PARAM) const&
+    {
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto or_else( F&& f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template<class F>
+    constexpr auto or_else( F&& f GB_EXPECTED_TRACE_PARAM) const&&
+    {
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    #pragma endregion
+
+    #pragma region transform_error
+
+    //transform error
+    template<class F>
+    constexpr auto transform_error( F&& f ) &
+    {
+        return detail::transform_error_impl(*this, std::forward<F>(f));
+    }
+
+    template<class F>
+    constexpr auto transform_error(F&& f) const&
+    {
+        return detail::transform_error_impl(*this, std::forward<F>(f));
+    }
+
+    template<class F>
+    constexpr auto transform_error( F&& f) &&
+    {
+        return detail::transform_error_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    template<class F>
+    constexpr auto transform_error( F&& f) const&&
+    {
+        return detail::transform_error_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    #pragma endregion
+
+    #pragma endregion
+
+private:
+    using __word_t = detail::niche_word_t<T>;
+
+    union __union_t
+    {
+        constexpr __union_t() : m_word() {}
+
+        T m_value;
+        __word_t m_word;
+    } m_value_error;
+};
+
+}
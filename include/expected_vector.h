@@ -0,0 +1,417 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "expected.h"
+#include "expected_algorithms.h"
+#include "expected_bitmap.h"
+
+namespace gb {
+
+template <class T, class E>
+class expected_vector;
+
+namespace detail {
+
+// Element of an expected_vector: behaves like expected<T, E>& for reading, converts to
+// expected<T, E>, and writes back on assignment.
+template <class T, class E, bool Const>
+class __expected_vector_reference
+{
+    using __vector_t = std::conditional_t<Const, const expected_vector<T, E>, expected_vector<T, E>>;
+    using __value_ref = std::conditional_t<Const, const T &, T &>;
+
+public:
+    constexpr __expected_vector_reference(__vector_t &v, std::size_t i) noexcept
+        : m_vector(&v), m_index(i)
+    {
+    }
+
+    operator __expected_vector_reference<T, E, true>() const noexcept
+        requires(!Const)
+    {
+        return {*m_vector, m_index};
+    }
+
+    bool has_value() const noexcept { return m_vector->m_ok.test(m_index); }
+    explicit operator bool() const noexcept { return has_value(); }
+
+    __value_ref operator*() const noexcept { return m_vector->m_values[m_index]; }
+    auto *operator->() const noexcept { return std::addressof(m_vector->m_values[m_index]); }
+
+    __value_ref value() const
+    {
+        if (!has_value())
+        {
+            if constexpr (std::is_void_v<E>)
+            {
+                detail::__fail_bad_expect_access();
+            }
+            else
+            {
+                detail::__fail_bad_expect_access(error());
+            }
+        }
+        return **this;
+    }
+
+    template <class U>
+    T value_or(U &&default_value) const
+    {
+        return has_value() ? **this : static_cast<T>(std::forward<U>(default_value));
+    }
+
+    const auto &error() const noexcept
+        requires(!std::is_void_v<E>)
+    {
+        return m_vector->__find_error(m_index)->error;
+    }
+
+    operator expected<T, E>() const
+    {
+        if (has_value())
+        {
+            return expected<T, E>(std::in_place, **this);
+        }
+        if constexpr (std::is_void_v<E>)
+        {
+            return expected<T, E>(unexpect);
+        }
+        else
+        {
+            return expected<T, E>(unexpect, error());
+        }
+    }
+
+    const __expected_vector_reference &operator=(const expected<T, E> &e) const
+        requires(!Const)
+    {
+        m_vector->__assign(m_index, e);
+        return *this;
+    }
+
+    const __expected_vector_reference &operator=(expected<T, E> &&e) const
+        requires(!Const)
+    {
+        m_vector->__assign(m_index, std::move(e));
+        return *this;
+    }
+
+    const __expected_vector_reference &operator=(const __expected_vector_reference &other) const
+        requires(!Const)
+    {
+        return *this = static_cast<expected<T, E>>(other);
+    }
+
+    friend bool operator==(const __expected_vector_reference &lhs, const expected<T, E> &rhs)
+    {
+        if (lhs.has_value() != rhs.has_value())
+        {
+            return false;
+        }
+        if (lhs.has_value())
+        {
+            return *lhs == *rhs;
+        }
+        if constexpr (std::is_void_v<E>)
+        {
+            return true;
+        }
+        else
+        {
+            return lhs.error() == rhs.error();
+        }
+    }
+
+private:
+    __vector_t *m_vector;
+    std::size_t m_index;
+};
+
+template <class T, class E, bool Const>
+class __expected_vector_iterator
+{
+    using __vector_t = std::conditional_t<Const, const expected_vector<T, E>, expected_vector<T, E>>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = expected<T, E>;
+    using difference_type = std::ptrdiff_t;
+    using reference = __expected_vector_reference<T, E, Const>;
+    using pointer = void;
+
+    __expected_vector_iterator() = default;
+
+    __expected_vector_iterator(__vector_t &v, std::size_t i) noexcept
+        : m_vector(&v), m_index(i)
+    {
+    }
+
+    operator __expected_vector_iterator<T, E, true>() const noexcept
+        requires(!Const)
+    {
+        return {*m_vector, m_index};
+    }
+
+    reference operator*() const noexcept { return {*m_vector, m_index}; }
+    reference operator[](difference_type n) const noexcept { return {*m_vector, m_index + n}; }
+
+    std::size_t index() const noexcept { return m_index; }
+
+    __expected_vector_iterator &operator++() noexcept { ++m_index; return *this; }
+    __expected_vector_iterator &operator--() noexcept { --m_index; return *this; }
+    __expected_vector_iterator operator++(int) noexcept { auto __t = *this; ++m_index; return __t; }
+    __expected_vector_iterator operator--(int) noexcept { auto __t = *this; --m_index; return __t; }
+    __expected_vector_iterator &operator+=(difference_type n) noexcept { m_index += n; return *this; }
+    __expected_vector_iterator &operator-=(difference_type n) noexcept { m_index -= n; return *this; }
+
+    friend __expected_vector_iterator operator+(__expected_vector_iterator it, difference_type n) noexcept { return it += n; }
+    friend __expected_vector_iterator operator+(difference_type n, __expected_vector_iterator it) noexcept { return it += n; }
+    friend __expected_vector_iterator operator-(__expected_vector_iterator it, difference_type n) noexcept { return it -= n; }
+
+    friend difference_type operator-(const __expected_vector_iterator &lhs, const __expected_vector_iterator &rhs) noexcept
+    {
+        return static_cast<difference_type>(lhs.m_index) - static_cast<difference_type>(rhs.m_index);
+    }
+
+    friend bool operator==(const __expected_vector_iterator &lhs, const __expected_vector_iterator &rhs) noexcept
+    {
+        return lhs.m_index == rhs.m_index;
+    }
+
+    friend auto operator<=>(const __expected_vector_iterator &lhs, const __expected_vector_iterator &rhs) noexcept
+    {
+        return lhs.m_index <=> rhs.m_index;
+    }
+
+private:
+    __vector_t *m_vector = nullptr;
+    std::size_t m_index = 0;
+};
+
+} // namespace detail
+
+// Structure of arrays batch of expected<T, E>. Values live in one dense column indexed like the
+// batch, validity in a bitmap, and errors in a side table sorted by index, so a batch that mostly
+// succeeds costs about sizeof(T) plus a bit per element and scans of the value column vectorize.
+// Slots of failed elements hold a value initialized T, so T must be default constructible.
+//
+// Elements are accessed through proxy references (see __expected_vector_reference); looking up
+// error() is a binary search over the error table.
+template <class T, class E>
+class expected_vector
+{
+    static_assert(!std::is_void_v<T>, "expected_vector stores a value column");
+    static_assert(std::is_default_constructible_v<T>, "failed slots of the value column hold a value initialized T");
+
+    template <class, class, bool>
+    friend class detail::__expected_vector_reference;
+
+public:
+    using value_type = expected<T, E>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = detail::__expected_vector_reference<T, E, false>;
+    using const_reference = detail::__expected_vector_reference<T, E, true>;
+    using iterator = detail::__expected_vector_iterator<T, E, false>;
+    using const_iterator = detail::__expected_vector_iterator<T, E, true>;
+    using error_entry = indexed_error<E>;
+
+    expected_vector() = default;
+
+    template <std::ranges::input_range R>
+        requires std::is_constructible_v<value_type, std::ranges::range_reference_t<R>>
+    explicit expected_vector(R &&r)
+    {
+        if constexpr (std::ranges::sized_range<R>)
+        {
+            reserve(static_cast<size_type>(std::ranges::size(r)));
+        }
+        for (auto &&__e : r)
+        {
+            push_back(value_type(std::forward<decltype(__e)>(__e)));
+        }
+    }
+
+    size_type size() const noexcept { return m_values.size(); }
+    bool empty() const noexcept { return m_values.empty(); }
+
+    void reserve(size_type n)
+    {
+        m_values.reserve(n);
+        m_ok.reserve(n);
+    }
+
+    void clear() noexcept
+    {
+        m_values.clear();
+        m_ok.clear();
+        m_errors.clear();
+    }
+
+    void push_back(const value_type &e)
+    {
+        if (e.has_value())
+        {
+            emplace_back(*e);
+        }
+        else if constexpr (std::is_void_v<E>)
+        {
+            emplace_back(unexpect);
+        }
+        else
+        {
+            emplace_back(unexpect, e.error());
+        }
+    }
+
+    void push_back(value_type &&e)
+    {
+        if (e.has_value())
+        {
+            emplace_back(*std::move(e));
+        }
+        else if constexpr (std::is_void_v<E>)
+        {
+            emplace_back(unexpect);
+        }
+        else
+        {
+            emplace_back(unexpect, std::move(e).error());
+        }
+    }
+
+    template <class... Args>
+        requires std::is_constructible_v<T, Args...>
+    reference emplace_back(Args &&...args)
+    {
+        m_values.emplace_back(std::forward<Args>(args)...);
+        m_ok.push_back(true);
+        return back();
+    }
+
+    template <class... Args>
+        requires(std::is_void_v<E> ? sizeof...(Args) == 0 : std::is_constructible_v<E, Args...>)
+    reference emplace_back(unexpect_t, Args &&...args)
+    {
+        if constexpr (std::is_void_v<E>)
+        {
+            m_errors.push_back(error_entry{size()});
+        }
+        else
+        {
+            m_errors.push_back(error_entry{size(), E(std::forward<Args>(args)...)});
+        }
+        m_values.emplace_back();
+        m_ok.push_back(false);
+        return back();
+    }
+
+    void pop_back()
+    {
+        if (!m_ok.test(size() - 1))
+        {
+            m_errors.pop_back();
+        }
+        m_values.pop_back();
+        m_ok.pop_back();
+    }
+
+    reference operator[](size_type i) noexcept { return {*this, i}; }
+    const_reference operator[](size_type i) const noexcept { return {*this, i}; }
+
+    reference back() noexcept { return {*this, size() - 1}; }
+    const_reference back() const noexcept { return {*this, size() - 1}; }
+
+    iterator begin() noexcept { return {*this, 0}; }
+    iterator end() noexcept { return {*this, size()}; }
+    const_iterator begin() const noexcept { return {*this, 0}; }
+    const_iterator end() const noexcept { return {*this, size()}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    size_type count_ok() const noexcept { return m_ok.count(); }
+    size_type count_error() const noexcept { return m_errors.size(); }
+    bool all_ok() const noexcept { return m_errors.empty(); }
+
+    // dense value column, indexed like the batch; slots of failed elements hold a placeholder
+    std::span<T> values() noexcept { return m_values; }
+    std::span<const T> values() const noexcept { return m_values; }
+
+    // validity of every element, one bit each: bit i % 64 of word i / 64, bits past size() clear
+    std::span<const std::uint64_t> ok_mask() const noexcept { return m_ok.words(); }
+
+    // failed elements in increasing index order
+    std::span<const error_entry> errors() const noexcept { return m_errors; }
+
+private:
+    const error_entry *__find_error(size_type i) const noexcept
+    {
+        return std::to_address(std::lower_bound(m_errors.begin(), m_errors.end(), i,
+                                                [](const error_entry &e, size_type index) { return e.index < index; }));
+    }
+
+    template <class Exp>
+    void __assign(size_type i, Exp &&e)
+    {
+        auto __it = std::lower_bound(m_errors.begin(), m_errors.end(), i,
+                                     [](const error_entry &x, size_type index) { return x.index < index; });
+        const bool __had_error = !m_ok.test(i);
+
+        if (e.has_value())
+        {
+            m_values[i] = *std::forward<Exp>(e);
+            if (__had_error)
+            {
+                m_errors.erase(__it);
+                m_ok.set(i);
+            }
+            return;
+        }
+
+        if constexpr (!std::is_void_v<E>)
+        {
+            if (__had_error)
+            {
+                __it->error = std::forward<Exp>(e).error();
+                return;
+            }
+            m_errors.insert(__it, error_entry{i, std::forward<Exp>(e).error()});
+        }
+        else if (!__had_error)
+        {
+            m_errors.insert(__it, error_entry{i});
+        }
+        m_values[i] = T();
+        m_ok.reset(i);
+    }
+
+    std::vector<T> m_values;
+    detail::bitmap m_ok;
+    std::vector<error_entry> m_errors;
+};
+
+} // namespace gb
+
+// a proxy and the expected it stands for meet at expected<T, E>, which makes the iterators
+// satisfy the standard iterator concepts
+template <class T, class E, bool Const, template <class> class TQual, template <class> class UQual>
+struct std::basic_common_reference<gb::detail::__expected_vector_reference<T, E, Const>, gb::expected<T, E>, TQual, UQual>
+{
+    using type = gb::expected<T, E>;
+};
+
+template <class T, class E, bool Const, template <class> class TQual, template <class> class UQual>
+struct std::basic_common_reference<gb::expected<T, E>, gb::detail::__expected_vector_reference<T, E, Const>, TQual, UQual>
+{
+    using type = gb::expected<T, E>;
+};
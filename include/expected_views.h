@@ -0,0 +1,310 @@
+#pragma once
+#include <concepts>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include "expected.h"
+
+// Lazy views over ranges of expected, to process streams of results without materializing them:
+//
+//   for (const config &c : files | std::views::transform(load) | gb::views::and_then(validate)
+//                                | gb::views::values)
+//
+//   views::and_then(f)      each element as exp.and_then(f)
+//   views::transform_ok(f)  each element as exp.transform(f)
+//   views::values           the values of the elements that hold one
+//   views::errors           the errors of the elements that hold one
+//   views::take_while_ok    the values up to the first error
+//
+// They allocate nothing and are used as `range | adaptor`; the result is a view that pipes into
+// the standard adaptors like any other. Elements may also be proxies that convert to the range's
+// value type (expected_vector). values, errors and take_while_ok read each element of the
+// underlying range once: an element produced on the fly (say by and_then) is kept in the iterator
+// instead of being produced a second time, which is what a filter followed by a transform does.
+namespace gb {
+namespace detail {
+
+// the element as the expected type of its range: itself, or the proxy converted
+template <class Exp, class Ref>
+constexpr decltype(auto) __as_expected(Ref &&e)
+{
+    if constexpr (std::is_same_v<std::remove_cvref_t<Ref>, Exp>)
+    {
+        return std::forward<Ref>(e);
+    }
+    else
+    {
+        return Exp(std::forward<Ref>(e));
+    }
+}
+
+template <class Exp, class F, bool Chain>
+struct __monadic_view_fn
+{
+    F m_f;
+
+    template <class Ref>
+    constexpr auto operator()(Ref &&e) const
+    {
+        if constexpr (Chain)
+        {
+            return and_then_impl(__as_expected<Exp>(std::forward<Ref>(e)), m_f);
+        }
+        else
+        {
+            return transform_impl(__as_expected<Exp>(std::forward<Ref>(e)), m_f);
+        }
+    }
+};
+
+template <class F, bool Chain>
+struct __monadic_view_closure
+{
+    F m_f;
+
+    template <std::ranges::viewable_range R>
+        requires is_expect_v<std::ranges::range_value_t<R>>
+    constexpr auto operator()(R &&r) const
+    {
+        using __fn_t = __monadic_view_fn<std::ranges::range_value_t<R>, F, Chain>;
+        return std::views::transform(std::forward<R>(r), __fn_t{m_f});
+    }
+
+    template <std::ranges::viewable_range R>
+        requires is_expect_v<std::ranges::range_value_t<R>>
+    friend constexpr auto operator|(R &&r, const __monadic_view_closure &c)
+    {
+        return c(std::forward<R>(r));
+    }
+};
+
+enum class __select
+{
+    __values,
+    __errors,
+    __values_until_error
+};
+
+template <std::ranges::input_range V, __select Mode>
+    requires std::ranges::view<V> && is_expect_v<std::ranges::range_value_t<V>>
+class __select_view : public std::ranges::view_interface<__select_view<V, Mode>>
+{
+    using __ref_t = std::ranges::range_reference_t<V>;
+
+    // an element produced by value is stored in the iterator, so it is produced once
+    static constexpr bool __caches = !std::is_reference_v<__ref_t>;
+    static constexpr bool __forward = !__caches && std::ranges::forward_range<V>;
+
+    class __sentinel;
+
+    class __iterator
+    {
+        friend class __sentinel;
+
+        using __cache_t = std::conditional_t<__caches, std::optional<std::remove_cvref_t<__ref_t>>, char>;
+
+    public:
+        using iterator_concept =
+            std::conditional_t<__forward, std::forward_iterator_tag, std::input_iterator_tag>;
+        using difference_type = std::ranges::range_difference_t<V>;
+        using value_type = std::conditional_t<Mode == __select::__errors,
+                                              std::remove_cvref_t<decltype(std::declval<__ref_t &>().error())>,
+                                              std::remove_cvref_t<decltype(*std::declval<__ref_t &>())>>;
+
+        __iterator() = default;
+
+        constexpr __iterator(__select_view &parent, std::ranges::iterator_t<V> it)
+            : m_parent(&parent), m_it(std::move(it))
+        {
+            __satisfy();
+        }
+
+        constexpr decltype(auto) operator*() const
+        {
+            if constexpr (Mode == __select::__errors)
+            {
+                return __element().error();
+            }
+            else
+            {
+                return *__element();
+            }
+        }
+
+        constexpr __iterator &operator++()
+        {
+            ++m_it;
+            __satisfy();
+            return *this;
+        }
+
+        constexpr void operator++(int)
+            requires(!__forward)
+        {
+            ++*this;
+        }
+
+        constexpr __iterator operator++(int)
+            requires __forward
+        {
+            auto __tmp = *this;
+            ++*this;
+            return __tmp;
+        }
+
+        friend constexpr bool operator==(const __iterator &x, const __iterator &y)
+            requires __forward
+        {
+            return x.m_it == y.m_it;
+        }
+
+    private:
+        constexpr decltype(auto) __element() const
+        {
+            if constexpr (__caches)
+            {
+                return *m_cache;
+            }
+            else
+            {
+                return *m_it;
+            }
+        }
+
+        // moves to the next element the view yields, or to the end
+        constexpr void __satisfy()
+        {
+            const auto __last = std::ranges::end(m_parent->m_base);
+            for (; m_it != __last; ++m_it)
+            {
+                if constexpr (__caches)
+                {
+                    m_cache.emplace(*m_it);
+                }
+                const bool __ok = __element().has_value();
+                if constexpr (Mode == __select::__values_until_error)
+                {
+                    m_stopped = !__ok;
+                    return;
+                }
+                else if (__ok == (Mode == __select::__values))
+                {
+                    return;
+                }
+            }
+        }
+
+        __select_view *m_parent = nullptr;
+        std::ranges::iterator_t<V> m_it = std::ranges::iterator_t<V>();
+        [[no_unique_address]] mutable __cache_t m_cache = __cache_t();
+        bool m_stopped = false;
+    };
+
+    class __sentinel
+    {
+    public:
+        __sentinel() = default;
+
+        constexpr explicit __sentinel(std::ranges::sentinel_t<V> end)
+            : m_end(std::move(end))
+        {
+        }
+
+        friend constexpr bool operator==(const __iterator &x, const __sentinel &y)
+        {
+            return y.__equal(x);
+        }
+
+    private:
+        constexpr bool __equal(const __iterator &x) const
+        {
+            return x.m_stopped || x.m_it == m_end;
+        }
+
+        std::ranges::sentinel_t<V> m_end = std::ranges::sentinel_t<V>();
+    };
+
+public:
+    __select_view()
+        requires std::default_initializable<V>
+    = default;
+
+    constexpr explicit __select_view(V base)
+        : m_base(std::move(base))
+    {
+    }
+
+    constexpr V base() const &
+        requires std::copy_constructible<V>
+    {
+        return m_base;
+    }
+
+    constexpr V base() && { return std::move(m_base); }
+
+    constexpr __iterator begin()
+    {
+        return {*this, std::ranges::begin(m_base)};
+    }
+
+    constexpr auto end()
+    {
+        if constexpr (Mode != __select::__values_until_error && __forward && std::ranges::common_range<V>)
+        {
+            return __iterator{*this, std::ranges::end(m_base)};
+        }
+        else
+        {
+            return __sentinel{std::ranges::end(m_base)};
+        }
+    }
+
+private:
+    V m_base = V();
+};
+
+template <__select Mode>
+struct __select_closure
+{
+    template <std::ranges::viewable_range R>
+        requires std::ranges::input_range<R> && is_expect_v<std::ranges::range_value_t<R>>
+    constexpr auto operator()(R &&r) const
+    {
+        return __select_view<std::views::all_t<R>, Mode>(std::views::all(std::forward<R>(r)));
+    }
+
+    template <std::ranges::viewable_range R>
+        requires std::ranges::input_range<R> && is_expect_v<std::ranges::range_value_t<R>>
+    friend constexpr auto operator|(R &&r, const __select_closure &c)
+    {
+        return c(std::forward<R>(r));
+    }
+};
+
+} // namespace detail
+
+namespace views {
+
+// f(value) -> the element's expected type, applied lazily as exp.and_then(f)
+template <class F>
+constexpr detail::__monadic_view_closure<std::decay_t<F>, true> and_then(F &&f)
+{
+    return {std::forward<F>(f)};
+}
+
+// f(value) -> U, applied lazily as exp.transform(f)
+template <class F>
+constexpr detail::__monadic_view_closure<std::decay_t<F>, false> transform_ok(F &&f)
+{
+    return {std::forward<F>(f)};
+}
+
+inline constexpr detail::__select_closure<detail::__select::__values> values{};
+inline constexpr detail::__select_closure<detail::__select::__errors> errors{};
+inline constexpr detail::__select_closure<detail::__select::__values_until_error> take_while_ok{};
+
+} // namespace views
+} // namespace gb
@@ -1,12 +1,17 @@
 #pragma once
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include "expected_base.h"
 #include "expected_monadic_operations.h"
+#include "expected_niche.h"
 
 
 namespace gb{
 
 template <class T, class E>
-    requires std::is_void_v<T> && (!std::is_void_v<E>)
+    requires std::is_void_v<T> && (!std::is_void_v<E>) && (!detail::has_niche<E>)
 struct expected<T, E>
 {
 
@@ -21,10 +26,11 @@ struct expected<T, E>
 
     constexpr expected(expect_t) : m_has_value{true} {}
 
-    constexpr expected(unexpect_t) noexcept(std::is_nothrow_default_constructible_v<E>) // strengthened
+    constexpr expected(unexpect_t GB_EXPECTED_TRACE_PARAM) noexcept(std::is_nothrow_default_constructible_v<E>) // strengthened
         requires std::is_default_constructible_v<E>
         : m_has_value(false)
     {
+        GB_EXPECTED_TRACE(created);
         std::construct_at(std::addressof(m_value_error.m_error));
     }
 
@@ -67,11 +73,11 @@ struct expected<T, E>
         requires detail::can_convert_void_value<E, _OtherErr, const _OtherErr &>::value
     constexpr explicit(!std::is_convertible_v<const _OtherErr &, E>)
         expected(const expected<void, _OtherErr> &other) noexcept(std::is_nothrow_constructible_v<E, const _OtherErr &>) // strengthened
-        : m_has_value(other.m_has_value)
+        : m_has_value(other.has_value())
     {
         if (!m_has_value)
         {
-            std::construct_at(std::addressof(m_value_error.m_error), other.m_value_error.m_error);
+            std::construct_at(std::addressof(m_value_error.m_error), other.error());
         }
     }
 
@@ -79,11 +85,11 @@ struct expected<T, E>
         requires detail::can_convert_void_value<E, _OtherErr, _OtherErr>::value
     constexpr explicit(!std::is_convertible_v<_OtherErr, E>)
         expected(expected<void, _OtherErr> &&other) noexcept(std::is_nothrow_constructible_v<E, _OtherErr>) // strengthened
-        : m_has_value(other.m_has_value)
+        : m_has_value(other.has_value())
     {
         if (!m_has_value)
         {
-            std::construct_at(std::addressof(m_value_error.m_error), std::move(other.m_value_error.m_error));
+            std::construct_at(std::addressof(m_value_error.m_error), std::move(other).error());
         }
     }
 
@@ -109,17 +115,19 @@ struct expected<T, E>
 
     template <class... _Args>
         requires std::is_constructible_v<E, _Args...>
-    constexpr explicit expected(unexpect_t, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, _Args...>) // strengthened
+    constexpr explicit expected(detail::__unexpect_at __tag, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, _Args...>) // strengthened
         : m_has_value(false)
     {
+        GB_EXPECTED_TRACE_UNEXPECT(__tag);
         std::construct_at(std::addressof(m_value_error.m_error), std::forward<_Args>(__args)...);
     }
 
     template <class _Up, class... _Args>
         requires std::is_constructible_v<E, std::initializer_list<_Up> &, _Args...>
-    constexpr explicit expected(unexpect_t, std::initializer_list<_Up> __il, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<_Up> &, _Args...>) // strengthened
+    constexpr explicit expected(detail::__unexpect_at __tag, std::initializer_list<_Up> __il, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<_Up> &, _Args...>) // strengthened
         : m_has_value(false)
     {
+        GB_EXPECTED_TRACE_UNEXPECT(__tag);
         std::construct_at(std::addressof(m_value_error.m_error), __il, std::forward<_Args>(__args)...);
     }
 
@@ -128,11 +136,11 @@ struct expected<T, E>
 #pragma region destructors
 
     constexpr ~expected()
-        requires(std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>)
+        requires std::is_trivially_destructible_v<E>
     = default;
 
     constexpr ~expected()
-        requires(!std::is_trivially_destructible_v<T> || !std::is_trivially_destructible_v<E>)
+        requires(!std::is_trivially_destructible_v<E>)
     {
         if (!m_has_value)
         {
@@ -201,10 +209,17 @@ private:
 public:
     constexpr expected &operator=(const expected &) = delete;
 
+    constexpr expected &operator=(const expected &)
+        requires(std::is_trivially_copy_assignable_v<E> &&
+                 std::is_trivially_copy_constructible_v<E> &&
+                 std::is_trivially_destructible_v<E>)
+    = default;
+
     constexpr expected &operator=(const expected &__rhs) noexcept(std::is_nothrow_copy_assignable_v<E> &&
                                                                   std::is_nothrow_copy_constructible_v<E>) // strengthened
         requires(std::is_copy_assignable_v<E> &&
-                 std::is_copy_constructible_v<E>)
+                 std::is_copy_constructible_v<E> &&
+                 !(std::is_trivially_copy_assignable_v<E> && std::is_trivially_copy_constructible_v<E> && std::is_trivially_destructible_v<E>))
     {
         if (m_has_value && __rhs.m_has_value)
         {
@@ -226,10 +241,17 @@ public:
         return *this;
     }
 
+    constexpr expected &operator=(expected &&)
+        requires(std::is_trivially_move_assignable_v<E> &&
+                 std::is_trivially_move_constructible_v<E> &&
+                 std::is_trivially_destructible_v<E>)
+    = default;
+
     constexpr expected &operator=(expected &&__rhs) noexcept(std::is_nothrow_move_assignable_v<E> &&
                                                              std::is_nothrow_move_constructible_v<E>)
         requires(std::is_move_constructible_v<E> &&
-                 std::is_move_assignable_v<E>)
+                 std::is_move_assignable_v<E> &&
+                 !(std::is_trivially_move_assignable_v<E> && std::is_trivially_move_constructible_v<E> && std::is_trivially_destructible_v<E>))
     {
         if (m_has_value && __rhs.m_has_value)
         {
@@ -354,7 +376,7 @@ public:
     // in place constructors is nonsense with void T
 
     // always present methods
-    operator bool() const noexcept { return m_has_value; }
+    explicit operator bool() const noexcept { return m_has_value; }
 
     bool has_value() const noexcept { return m_has_value; }
 
@@ -415,25 +437,25 @@ public:
     constexpr void value() &
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>(error());
+            detail::__fail_bad_expect_access(error());
     }
 
     constexpr void value() &&
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>(error());
+            detail::__fail_bad_expect_access(std::move(error()));
     }
 
     constexpr const void value() const &
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>(error());
+            detail::__fail_bad_expect_access(error());
     }
 
     constexpr const void value() const &&
     {
         if (!m_has_value)
-            throw new bad_expect_access<E>(error());
+            detail::__fail_bad_expect_access(std::move(error()));
     }
 
     // value or is nonsense with void type
@@ -444,27 +466,27 @@ public:
     // and_then
     template <class F>
         requires std::is_invocable_v<F, T> && (is_expect_v<std::invoke_result_t<F, T>> || std::is_same_v<std::invoke_result_t<F, T>, T>)
-    constexpr auto and_then(F &&f) &
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) &
     {
-        return detail::and_then_impl(*this, std::forward<F>(f));
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto and_then(F &&f) const &
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) const &
     {
-        return detail::and_then_impl(*this, std::forward<F>(f));
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto and_then(F &&f) &&
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) &&
     {
-        return detail::and_then_impl(std::move(*this), std::forward<F>(f));
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto and_then(F &&f) const &&
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) const &&
     {
-        return detail::and_then_impl(std::move(*this), std::forward<F>(f));
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
 #pragma endregion
@@ -473,27 +495,27 @@ public:
 
     // transform
     template <class F>
-    constexpr auto transform(F &&f) &
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) &
     {
-        return detail::transform_impl(*this, std::forward<F>(f));
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto transform(F &&f) const &
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) const &
     {
-        return detail::transform_impl(*this, std::forward<F>(f));
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto transform(F &&f) &&
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) &&
     {
-        return detail::transform_impl(std::move(*this), std::forward<F>(f));
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto transform(F &&f) const &&
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) const &&
     {
-        return detail::transform_impl(std::move(*this), std::forward<F>(f));
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
 #pragma endregion
@@ -502,27 +524,27 @@ public:
 
     // transform
     template <class F>
-    constexpr auto or_else(F &&f) &
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) &
     {
-        return detail::or_else_impl(*this, std::forward<F>(f));
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto or_else(F &&f) const &
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) const &
     {
-        return detail::or_else_impl(*this, std::forward<F>(f));
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto or_else(F &&f) &&
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) &&
     {
-        return detail::or_else_impl(std::move(*this), std::forward<F>(f));
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
     template <class F>
-    constexpr auto or_else(F &&f) const &&
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) const &&
     {
-        return detail::or_else_impl(std::move(*this), std::forward<F>(f));
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
     }
 
 #pragma endregion
@@ -568,12 +590,12 @@ private:
         constexpr __union_t() : __empty_() {}
 
         constexpr ~__union_t()
-            requires(std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>)
+            requires std::is_trivially_destructible_v<E>
         = default;
 
         // the expected's destructor handles this
         constexpr ~__union_t()
-            requires(!std::is_trivially_destructible_v<T> || !std::is_trivially_destructible_v<E>)
+            requires(!std::is_trivially_destructible_v<E>)
         {
         }
 
@@ -0,0 +1,366 @@
+#pragma once
+#include <bit>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "expected_base.h"
+#include "expected_monadic_operations.h"
+#include "expected_niche.h"
+
+
+namespace gb{
+
+// E declares a free low bit through niche_traits: the value state is a word with that bit set,
+// so the expected is exactly sizeof(E).
+template <class T, class E>
+    requires std::is_void_v<T> && (!std::is_void_v<E>) && detail::has_niche<E>
+struct expected<T, E>
+{
+
+#pragma region constructors
+
+#pragma region default empty/copy/move constructors
+
+    constexpr expected() noexcept // strengthened
+    {
+    }
+
+    constexpr expected(expect_t) noexcept {}
+
+    constexpr expected(unexpect_t GB_EXPECTED_TRACE_PARAM) noexcept(std::is_nothrow_default_constructible_v<E>) // strengthened
+        requires std::is_default_constructible_v<E>
+    {
+        GB_EXPECTED_TRACE(created);
+        std::construct_at(std::addressof(m_value_error.m_error));
+    }
+
+    // E is trivially copyable, so are we
+    constexpr expected(const expected &) = default;
+    constexpr expected(expected &&) = default;
+
+#pragma endregion
+
+#pragma region conversion constructors
+
+    template <class _OtherErr>
+        requires detail::can_convert_void_value<E, _OtherErr, const _OtherErr &>::value
+    constexpr explicit(!std::is_convertible_v<const _OtherErr &, E>)
+        expected(const expected<void, _OtherErr> &other) noexcept(std::is_nothrow_constructible_v<E, const _OtherErr &>) // strengthened
+    {
+        if (!other.has_value())
+        {
+            std::construct_at(std::addressof(m_value_error.m_error), other.error());
+        }
+    }
+
+    template <class _OtherErr>
+        requires detail::can_convert_void_value<E, _OtherErr, _OtherErr>::value
+    constexpr explicit(!std::is_convertible_v<_OtherErr, E>)
+        expected(expected<void, _OtherErr> &&other) noexcept(std::is_nothrow_constructible_v<E, _OtherErr>) // strengthened
+    {
+        if (!other.has_value())
+        {
+            std::construct_at(std::addressof(m_value_error.m_error), std::move(other).error());
+        }
+    }
+
+#pragma endregion
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, const _OtherErr &>
+    constexpr explicit(!std::is_convertible_v<const _OtherErr &, E>)
+        expected(const unexpected<_OtherErr> &err) noexcept(std::is_nothrow_constructible_v<E, const _OtherErr &>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_error), err.error());
+    }
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, _OtherErr>
+    constexpr explicit(!std::is_convertible_v<_OtherErr, E>)
+        expected(unexpected<_OtherErr> &&err) noexcept(std::is_nothrow_constructible_v<E, _OtherErr>) // strengthened
+    {
+        std::construct_at(std::addressof(m_value_error.m_error), std::move(err.error()));
+    }
+
+    template <class... _Args>
+        requires std::is_constructible_v<E, _Args...>
+    constexpr explicit expected(detail::__unexpect_at __tag, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, _Args...>) // strengthened
+    {
+        GB_EXPECTED_TRACE_UNEXPECT(__tag);
+        std::construct_at(std::addressof(m_value_error.m_error), std::forward<_Args>(__args)...);
+    }
+
+    template <class _Up, class... _Args>
+        requires std::is_constructible_v<E, std::initializer_list<_Up> &, _Args...>
+    constexpr explicit expected(detail::__unexpect_at __tag, std::initializer_list<_Up> __il, _Args &&...__args) noexcept(std::is_nothrow_constructible_v<E, std::initializer_list<_Up> &, _Args...>) // strengthened
+    {
+        GB_EXPECTED_TRACE_UNEXPECT(__tag);
+        std::construct_at(std::addressof(m_value_error.m_error), __il, std::forward<_Args>(__args)...);
+    }
+
+#pragma endregion
+
+#pragma region destructors
+
+    constexpr ~expected() = default;
+
+#pragma endregion
+
+#pragma region assignments
+
+    constexpr expected &operator=(const expected &) = default;
+    constexpr expected &operator=(expected &&) = default;
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, const _OtherErr &>
+    constexpr expected &operator=(const unexpected<_OtherErr> &__un)
+    {
+        std::construct_at(std::addressof(m_value_error.m_error), __un.error());
+        return *this;
+    }
+
+    template <class _OtherErr>
+        requires std::is_constructible_v<E, _OtherErr>
+    constexpr expected &operator=(unexpected<_OtherErr> &&__un)
+    {
+        std::construct_at(std::addressof(m_value_error.m_error), std::move(__un.error()));
+        return *this;
+    }
+
+#pragma endregion
+
+#pragma region swap
+
+    constexpr void swap(expected &__rhs) noexcept
+    {
+        std::swap(m_value_error, __rhs.m_value_error);
+    }
+
+    friend constexpr void swap(expected &__x, expected &__y) noexcept
+    {
+        __x.swap(__y);
+    }
+
+#pragma endregion
+
+    // in place constructors is nonsense with void T
+
+    // always present methods
+    explicit operator bool() const noexcept { return has_value(); }
+
+    bool has_value() const noexcept { return (std::bit_cast<__word_t>(m_value_error) & detail::niche_tag) != 0; }
+
+    // only for E not void
+    constexpr const E &error() const & noexcept
+    {
+        return m_value_error.m_error;
+    }
+
+    constexpr E &error() & noexcept
+    {
+        return m_value_error.m_error;
+    }
+
+    constexpr const E &&error() const && noexcept
+    {
+        return std::move(m_value_error.m_error);
+    }
+
+    constexpr E &&error() && noexcept
+    {
+        return std::move(m_value_error.m_error);
+    }
+
+    // only for T not void
+    constexpr void operator->() &
+    {
+    }
+
+    constexpr void operator->() &&
+    {
+    }
+
+    constexpr void operator->() const &
+    {
+    }
+
+    constexpr void operator->() const &&
+    {
+    }
+
+    constexpr void operator*() &
+    {
+    }
+
+    constexpr void operator*() &&
+    {
+    }
+
+    constexpr void operator*() const &
+    {
+    }
+
+    constexpr void operator*() const &&
+    {
+    }
+
+    constexpr void value() &
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(error());
+    }
+
+    constexpr void value() &&
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(std::move(error()));
+    }
+
+    constexpr void value() const &
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(error());
+    }
+
+    constexpr void value() const &&
+    {
+        if (!has_value())
+            detail::__fail_bad_expect_access(std::move(error()));
+    }
+
+    // value or is nonsense with void type
+
+#pragma region Monadic operations
+
+#pragma region and_then
+    // and_then
+    template <class F>
+        requires std::is_invocable_v<F, T> && (is_expect_v<std::invoke_result_t<F, T>> || std::is_same_v<std::invoke_result_t<F, T>, T>)
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) const &
+    {
+        return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto and_then(F &&f GB_EXPECTED_TRACE_PARAM) const &&
+    {
+        return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+#pragma endregion
+
+#pragma region transform
+
+    // transform
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) const &
+    {
+        return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto transform(F &&f GB_EXPECTED_TRACE_PARAM) const &&
+    {
+        return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+#pragma endregion
+
+#pragma region or_else
+
+    // transform
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) &
+    {
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) const &
+    {
+        return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) &&
+    {
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+    template <class F>
+    constexpr auto or_else(F &&f GB_EXPECTED_TRACE_PARAM) const &&
+    {
+        return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
+    }
+
+#pragma endregion
+
+#pragma region transform_error
+
+    // transform error
+    template <class F>
+    constexpr auto transform_error(F &&f) &
+    {
+        return detail::transform_error_impl(*this, std::forward<F>(f));
+    }
+
+    template <class F>
+    constexpr auto transform_error(F &&f) const &
+    {
+        return detail::transform_error_impl(*this, std::forward<F>(f));
+    }
+
+    template <class F>
+    constexpr auto transform_error(F &&f) &&
+    {
+        return detail::transform_error_impl(std::move(*this), std::forward<F>(f));
+    }
+
+    template <class F>
+    constexpr auto transform_error(F &&f) const &&
+    {
+        return detail::transform_error_impl(std::move(*this), std::forward<F>(f));
+    }
+
+#pragma endregion
+
+#pragma endregion
+
+private:
+    using __word_t = detail::niche_word_t<E>;
+
+    union __union_t
+    {
+        constexpr __union_t() : m_word(detail::niche_tag) {}
+
+        E m_error;
+        __word_t m_word;
+    } m_value_error;
+};
+}
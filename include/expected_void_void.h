@@ -1,5 +1,6 @@
 #pragma once
 #include <type_traits>
+#include <utility>
 #include "expected_base.h"
 #include "expected_monadic_operations.h"
 
@@ -16,16 +17,22 @@ struct expected<T, E>
   }
 
   //error constructors
-  constexpr expected(const unexpect_t&) noexcept
+  constexpr expected(const unexpect_t& GB_EXPECTED_TRACE_PARAM) noexcept
       : m_has_value {false}
   {
+    GB_EXPECTED_TRACE(created);
   }
-  constexpr expected(unexpect_t&&) noexcept
+  constexpr expected(unexpect_t&& GB_EXPECTED_TRACE_PARAM) noexcept
       : m_has_value {false}
   {
+    GB_EXPECTED_TRACE(created);
   }
 
-  constexpr expected& operator=(const unexpect_t&) noexcept { m_has_value = false; }
+  constexpr expected& operator=(const unexpect_t&) noexcept
+  {
+    m_has_value = false;
+    return *this;
+  }
 
   constexpr expected& operator=(unexpect_t&&) noexcept
   {
@@ -55,33 +62,18 @@ struct expected<T, E>
     return *this;
   }
 
-  //copy constructor and assignment
-  constexpr expected(const expected& other) noexcept
-      : m_has_value {other.m_has_value}
-  {
-  }
-  constexpr expected& operator=(const expected& other) noexcept
-  {
-    m_has_value = other.m_has_value;
-    return *this;
-  }
+  //copy constructor and assignment, trivial: the flag is all there is
+  constexpr expected(const expected&) noexcept = default;
+  constexpr expected& operator=(const expected&) noexcept = default;
 
   //move constructor and assignment
-  constexpr expected(expected&& other) noexcept
-      : m_has_value {other.m_has_value}
-  {
-  }
-  constexpr expected& operator=(expected&& other) noexcept
-  {
-    using std::swap;
-    swap(m_has_value, other.m_has_value);
-    return *this;
-  }
+  constexpr expected(expected&&) noexcept = default;
+  constexpr expected& operator=(expected&&) noexcept = default;
 
   //in place constructors is nonsense with void T
 
   //always present methods
-  operator bool() const noexcept { return m_has_value; }
+  explicit operator bool() const noexcept { return m_has_value; }
 
   bool has_value() const noexcept { return m_has_value; }
 
@@ -122,25 +114,25 @@ struct expected<T, E>
   constexpr void value() &
   {
     if (!m_has_value)
-      throw new bad_expect_access<E>(error());
+      detail::__fail_bad_expect_access();
   }
 
   constexpr void value() &&
   {
     if (!m_has_value)
-      throw new bad_expect_access<E>(error());
+      detail::__fail_bad_expect_access();
   }
 
   constexpr const void value() const&
   {
     if (!m_has_value)
-      throw new bad_expect_access<E>(error());
+      detail::__fail_bad_expect_access();
   }
 
   constexpr const void value() const&&
   {
     if (!m_has_value)
-      throw new bad_expect_access<E>(error());
+      detail::__fail_bad_expect_access();
   }
 
   //value or is nonsense with void type
@@ -151,27 +143,27 @@ struct expected<T, E>
   //and_then
   template<class F>
     requires std::is_invocable_v<F, T> && (is_expect_v<std::invoke_result_t<F, T>> || std::is_same_v<std::invoke_result_t<F, T>, T>)
-  constexpr auto and_then(F&& f) &
+  constexpr auto and_then(F&& f GB_EXPECTED_TRACE_PARAM) &
   {
-    return detail::and_then_impl(*this, std::forward<F>(f));
+    return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto and_then(F&& f) const&
+  constexpr auto and_then(F&& f GB_EXPECTED_TRACE_PARAM) const&
   {
-    return detail::and_then_impl(*this, std::forward<F>(f));
+    return detail::and_then_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto and_then(F&& f) &&
+  constexpr auto and_then(F&& f GB_EXPECTED_TRACE_PARAM) &&
   {
-    return detail::and_then_impl(std::move(*this), std::forward<F>(f));
+    return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto and_then(F&& f) const&&
+  constexpr auto and_then(F&& f GB_EXPECTED_TRACE_PARAM) const&&
   {
-    return detail::and_then_impl(std::move(*this), std::forward<F>(f));
+    return detail::and_then_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
 #pragma endregion
@@ -180,27 +172,27 @@ struct expected<T, E>
 
   //transform
   template<class F>
-  constexpr auto transform(F&& f) &
+  constexpr auto transform(F&& f GB_EXPECTED_TRACE_PARAM) &
   {
-    return detail::transform_impl(*this, std::forward<F>(f));
+    return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto transform(F&& f) const&
+  constexpr auto transform(F&& f GB_EXPECTED_TRACE_PARAM) const&
   {
-    return detail::transform_impl(*this, std::forward<F>(f));
+    return detail::transform_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto transform(F&& f) &&
+  constexpr auto transform(F&& f GB_EXPECTED_TRACE_PARAM) &&
   {
-    return detail::transform_impl(std::move(*this), std::forward<F>(f));
+    return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto transform(F&& f) const&&
+  constexpr auto transform(F&& f GB_EXPECTED_TRACE_PARAM) const&&
   {
-    return detail::transform_impl(std::move(*this), std::forward<F>(f));
+    return detail::transform_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
 #pragma endregion
@@ -209,27 +201,27 @@ struct expected<T, E>
 
   //transform
   template<class F>
-  constexpr auto or_else(F&& f) &
+  constexpr auto or_else(F&& f GB_EXPECTED_TRACE_PARAM) &
   {
-    return detail::or_else_impl(*this, std::forward<F>(f));
+    return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto or_else(F&& f) const&
+  constexpr auto or_else(F&& f GB_EXPECTED_TRACE_PARAM) const&
   {
-    return detail::or_else_impl(*this, std::forward<F>(f));
+    return detail::or_else_impl(*this, std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto or_else(F&& f) &&
+  constexpr auto or_else(F&& f GB_EXPECTED_TRACE_PARAM) &&
   {
-    return detail::or_else_impl(std::move(*this), std::forward<F>(f));
+    return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
   template<class F>
-  constexpr auto or_else(F&& f) const&&
+  constexpr auto or_else(F&& f GB_EXPECTED_TRACE_PARAM) const&&
   {
-    return detail::or_else_impl(std::move(*this), std::forward<F>(f));
+    return detail::or_else_impl(std::move(*this), std::forward<F>(f) GB_EXPECTED_TRACE_ARG);
   }
 
 #pragma endregion
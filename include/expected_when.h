@@ -0,0 +1,305 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "expected_future.h"
+
+// Combinators over gb::future. Each input gets a continuation node from one preallocated array;
+// the nodes fan in on a single atomic counter and write their results into preallocated slots,
+// so no per-input allocation or lock is involved. The combined future completes as soon as the
+// outcome is known; inputs that settle later are discarded (futures cannot be cancelled, their
+// producers simply finish into nothing). The last input to settle frees the fan-in state.
+namespace gb {
+namespace detail {
+
+// slot type of an input in a tuple result
+template <class T>
+using __when_slot_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+template <class T, class E, class Owner>
+struct __when_node : __continuation<T, E>
+{
+    Owner *m_owner;
+    std::size_t m_index;
+};
+
+template <class T, class E, class Owner>
+void __when_attach(future<T, E> &f, __when_node<T, E, Owner> &node) noexcept
+{
+    auto *__s = __future_access::take(f);
+    __s->attach(&node);
+    __s->release(__future_state<T, E>::__future_gone);
+}
+
+template <class T, class E>
+struct __when_all_range
+{
+    using __node = __when_node<T, E, __when_all_range>;
+    using result_type = std::conditional_t<std::is_void_v<T>, void, std::vector<__when_slot_t<T>>>;
+
+    explicit __when_all_range(std::size_t n)
+        : m_remaining(n), m_nodes(new __node[n]), m_slots(new std::optional<__when_slot_t<T>>[n])
+    {
+    }
+
+    static void __run(__continuation<T, E> *c, std::optional<expected<T, E>> *r) noexcept
+    {
+        auto *__n = static_cast<__node *>(c);
+        auto *__self = __n->m_owner;
+
+        if (r && (*r)->has_value())
+        {
+            if constexpr (!std::is_void_v<T>)
+            {
+                __self->m_slots[__n->m_index].emplace(**std::move(*r));
+            }
+        }
+        else if (!__self->m_failed.exchange(true, std::memory_order_relaxed))
+        {
+            // the first error or broken input wins; a promise dropped unsatisfied is broken
+            if (!r)
+            {
+                auto __dropped = std::move(__self->m_promise);
+            }
+            else if constexpr (std::is_void_v<E>)
+            {
+                __self->m_promise.set_error();
+            }
+            else
+            {
+                __self->m_promise.set_error(std::move(**r).error());
+            }
+        }
+
+        if (__self->m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            __self->__finish();
+        }
+    }
+
+    void __finish() noexcept
+    {
+        if (!m_failed.load(std::memory_order_relaxed))
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                m_promise.set_value();
+            }
+            else
+            {
+                std::vector<T> __values;
+                __values.reserve(m_count);
+                for (std::size_t __i = 0; __i < m_count; ++__i)
+                {
+                    __values.push_back(std::move(*m_slots[__i]));
+                }
+                m_promise.set_value(std::move(__values));
+            }
+        }
+        delete this;
+    }
+
+    std::atomic<std::size_t> m_remaining;
+    std::atomic<bool> m_failed{false};
+    std::size_t m_count = m_remaining.load(std::memory_order_relaxed);
+    std::unique_ptr<__node[]> m_nodes;
+    std::unique_ptr<std::optional<__when_slot_t<T>>[]> m_slots;
+    promise<result_type, E> m_promise;
+};
+
+template <class T, class E>
+struct __when_any_range
+{
+    using __node = __when_node<T, E, __when_any_range>;
+
+    explicit __when_any_range(std::size_t n)
+        : m_remaining(n), m_nodes(new __node[n])
+    {
+    }
+
+    static void __run(__continuation<T, E> *c, std::optional<expected<T, E>> *r) noexcept
+    {
+        auto *__self = static_cast<__node *>(c)->m_owner;
+
+        if (r && (*r)->has_value() && !__self->m_won.exchange(true, std::memory_order_relaxed))
+        {
+            __self->m_promise.set(std::move(**r));
+        }
+
+        if (__self->m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // every input failed: report the error that arrived last
+            if (!__self->m_won.load(std::memory_order_relaxed) && r)
+            {
+                __self->m_promise.set(std::move(**r));
+            }
+            delete __self;
+        }
+    }
+
+    std::atomic<std::size_t> m_remaining;
+    std::atomic<bool> m_won{false};
+    std::unique_ptr<__node[]> m_nodes;
+    promise<T, E> m_promise;
+};
+
+template <class E, class Seq, class... Ts>
+struct __when_all_tuple;
+
+template <class E, std::size_t... Is, class... Ts>
+struct __when_all_tuple<E, std::index_sequence<Is...>, Ts...>
+{
+    using result_type = std::tuple<__when_slot_t<Ts>...>;
+
+    template <std::size_t I>
+    using __type_at = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    template <std::size_t I>
+    static void __run(__continuation<__type_at<I>, E> *c, std::optional<expected<__type_at<I>, E>> *r) noexcept
+    {
+        auto *__self = static_cast<__when_node<__type_at<I>, E, __when_all_tuple> *>(c)->m_owner;
+
+        if (r && (*r)->has_value())
+        {
+            if constexpr (std::is_void_v<__type_at<I>>)
+            {
+                std::get<I>(__self->m_slots).emplace();
+            }
+            else
+            {
+                std::get<I>(__self->m_slots).emplace(**std::move(*r));
+            }
+        }
+        else if (!__self->m_failed.exchange(true, std::memory_order_relaxed))
+        {
+            if (!r)
+            {
+                auto __dropped = std::move(__self->m_promise);
+            }
+            else if constexpr (std::is_void_v<E>)
+            {
+                __self->m_promise.set_error();
+            }
+            else
+            {
+                __self->m_promise.set_error(std::move(**r).error());
+            }
+        }
+
+        if (__self->m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            if (!__self->m_failed.load(std::memory_order_relaxed))
+            {
+                __self->m_promise.set_value(std::move(*std::get<Is>(__self->m_slots))...);
+            }
+            delete __self;
+        }
+    }
+
+    std::atomic<std::size_t> m_remaining{sizeof...(Ts)};
+    std::atomic<bool> m_failed{false};
+    std::tuple<__when_node<Ts, E, __when_all_tuple>...> m_nodes;
+    std::tuple<std::optional<__when_slot_t<Ts>>...> m_slots;
+    promise<result_type, E> m_promise;
+};
+
+} // namespace detail
+
+// Completes with every value in input order once all inputs have values, or with the first
+// error as soon as one arrives; an input whose promise was broken breaks the result just as soon.
+// An empty range completes immediately.
+template <class T, class E>
+auto when_all(std::vector<future<T, E>> inputs)
+{
+    using __state_t = detail::__when_all_range<T, E>;
+
+    auto *__s = new __state_t(inputs.size());
+    auto __result = __s->m_promise.get_future();
+    if (inputs.empty())
+    {
+        __s->__finish();
+        return __result;
+    }
+
+    for (std::size_t __i = 0; __i < inputs.size(); ++__i)
+    {
+        __s->m_nodes[__i].m_run = &__state_t::__run;
+        __s->m_nodes[__i].m_owner = __s;
+        __s->m_nodes[__i].m_index = __i;
+    }
+    // the last attach may complete and free the state, so nothing of it is touched afterwards
+    auto *__nodes = __s->m_nodes.get();
+    for (std::size_t __i = 0; __i < inputs.size(); ++__i)
+    {
+        detail::__when_attach(inputs[__i], __nodes[__i]);
+    }
+    return __result;
+}
+
+// Tuple of every value (std::monostate for void inputs), or the first error or broken input
+template <class E, class... Ts>
+future<std::tuple<detail::__when_slot_t<Ts>...>, E> when_all(future<Ts, E>... inputs)
+{
+    using __state_t = detail::__when_all_tuple<E, std::index_sequence_for<Ts...>, Ts...>;
+
+    auto *__s = new __state_t();
+    auto __result = __s->m_promise.get_future();
+    [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        ((std::get<Is>(__s->m_nodes).m_run = &__state_t::template __run<Is>,
+          std::get<Is>(__s->m_nodes).m_owner = __s,
+          std::get<Is>(__s->m_nodes).m_index = Is),
+         ...);
+        auto &__nodes = __s->m_nodes;
+        (detail::__when_attach(inputs, std::get<Is>(__nodes)), ...);
+    }(std::index_sequence_for<Ts...>{});
+    return __result;
+}
+
+// Completes with the first value to arrive, or with the last error once every input failed.
+// An empty range yields a broken future.
+template <class T, class E>
+future<T, E> when_any(std::vector<future<T, E>> inputs)
+{
+    using __state_t = detail::__when_any_range<T, E>;
+
+    auto *__s = new __state_t(inputs.size());
+    auto __result = __s->m_promise.get_future();
+    if (inputs.empty())
+    {
+        delete __s;
+        return __result;
+    }
+
+    for (std::size_t __i = 0; __i < inputs.size(); ++__i)
+    {
+        __s->m_nodes[__i].m_run = &__state_t::__run;
+        __s->m_nodes[__i].m_owner = __s;
+        __s->m_nodes[__i].m_index = __i;
+    }
+    auto *__nodes = __s->m_nodes.get();
+    for (std::size_t __i = 0; __i < inputs.size(); ++__i)
+    {
+        detail::__when_attach(inputs[__i], __nodes[__i]);
+    }
+    return __result;
+}
+
+template <class T, class E, class... Rest>
+    requires(std::is_same_v<Rest, future<T, E>> && ...)
+future<T, E> when_any(future<T, E> first, Rest... rest)
+{
+    std::vector<future<T, E>> __inputs;
+    __inputs.reserve(1 + sizeof...(Rest));
+    __inputs.push_back(std::move(first));
+    (__inputs.push_back(std::move(rest)), ...);
+    return when_any(std::move(__inputs));
+}
+
+} // namespace gb
@@ -0,0 +1,145 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "expected.h"
+
+// Several fallible inputs at once, instead of nested and_then calls:
+//
+//   expected<order, errc> o = gb::zip(parse_id(a), parse_qty(b), parse_price(c))
+//                                 .transform([](int id, int qty, double price) { return order{id, qty, price}; });
+//
+// The has_value flags of all inputs are combined without short-circuiting, so the success path
+// tests one condition and builds no intermediate expected. f receives the values of the inputs that
+// have one (void values are left out); if any input failed, the result carries the error of the
+// first one that did. All inputs must share the same error type, which may be void.
+namespace gb {
+namespace detail {
+
+template <class... Exps>
+class __zip
+{
+    static_assert(sizeof...(Exps) > 0);
+    static_assert((is_expect_v<std::remove_cvref_t<Exps>> && ...), "zip combines expected values");
+
+    using __first_t = std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Exps...>>>;
+
+public:
+    using error_type = expect_error_t<__first_t>;
+
+    static_assert((std::is_same_v<expect_error_t<std::remove_cvref_t<Exps>>, error_type> && ...),
+                  "zip inputs must share their error type");
+
+    constexpr explicit __zip(Exps &&...exps) noexcept
+        : m_exps(std::forward<Exps>(exps)...)
+    {
+    }
+
+    // expected<invoke_result_t<F, values...>, E>, holding a copy of what a reference-returning f refers to
+    template <class F>
+    constexpr auto transform(F &&f) &&
+    {
+        using __r_t = std::remove_cvref_t<decltype(__call(f))>;
+        using __result_t = expected<__r_t, error_type>;
+
+        if (__all_ok()) [[likely]]
+        {
+            if constexpr (std::is_void_v<__r_t>)
+            {
+                __call(f);
+                return __result_t(expect);
+            }
+            else
+            {
+                return __result_t(std::in_place, __call(f));
+            }
+        }
+        return __first_error<__result_t>();
+    }
+
+    // f(values...) -> expected<U, E>
+    template <class F>
+    constexpr auto and_then(F &&f) &&
+    {
+        using __result_t = std::remove_cvref_t<decltype(__call(f))>;
+        static_assert(is_expect_v<__result_t> && std::is_same_v<expect_error_t<__result_t>, error_type>,
+                      "and_then must return an expected with the same error type");
+
+        if (__all_ok()) [[likely]]
+        {
+            return __result_t(__call(f));
+        }
+        return __first_error<__result_t>();
+    }
+
+private:
+    template <std::size_t I>
+    using __exp_t = std::tuple_element_t<I, std::tuple<Exps...>>;
+
+    // the flags are counted rather than and-ed: GCC splits a chain of & on bools back into jumps
+    constexpr bool __all_ok() const noexcept
+    {
+        return std::apply(
+            [](const auto &...e) { return (static_cast<unsigned>(e.has_value()) + ...) == sizeof...(Exps); }, m_exps);
+    }
+
+    // the value of input I as a one-element tuple, or an empty tuple for a void value
+    template <std::size_t I>
+    constexpr auto __value_arg()
+    {
+        if constexpr (std::is_void_v<expect_value_t<__exp_t<I>>>)
+        {
+            return std::tuple<>();
+        }
+        else
+        {
+            return std::forward_as_tuple(*std::forward<__exp_t<I>>(std::get<I>(m_exps)));
+        }
+    }
+
+    template <class F>
+    constexpr decltype(auto) __call(F &f)
+    {
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>) -> decltype(auto) {
+            return std::apply(f, std::tuple_cat(__value_arg<Is>()...));
+        }(std::index_sequence_for<Exps...>{});
+    }
+
+    // called once some input failed, so if none before the last did, the last one has
+    template <class Result, std::size_t I = 0>
+    constexpr Result __first_error()
+    {
+        if constexpr (I + 1 < sizeof...(Exps))
+        {
+            if (std::get<I>(m_exps).has_value())
+            {
+                return __first_error<Result, I + 1>();
+            }
+        }
+        if constexpr (std::is_void_v<error_type>)
+        {
+            return Result(unexpect);
+        }
+        else
+        {
+            return Result(unexpect, std::forward<__exp_t<I>>(std::get<I>(m_exps)).error());
+        }
+    }
+
+    std::tuple<Exps &&...> m_exps;
+};
+
+} // namespace detail
+
+// The inputs are held by reference: use the result in the same expression
+template <class... Exps>
+    requires(sizeof...(Exps) > 0 && (is_expect_v<std::remove_cvref_t<Exps>> && ...))
+constexpr detail::__zip<Exps...> zip(Exps &&...exps) noexcept
+{
+    return detail::__zip<Exps...>(std::forward<Exps>(exps)...);
+}
+
+} // namespace gb
@@ -0,0 +1,243 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "exception_guard.h"
+#include "trivially_relocatable.h"
+
+namespace gb {
+
+// Vector with room for N elements inline, meant for batches of expected. Whenever elements
+// change address (growth, moves of the whole vector, erase), trivially relocatable element
+// types are moved with memcpy/memmove instead of a move construction plus a destruction per
+// element, so growing a buffer of expected<std::unique_ptr<Job>, E> is a single copy.
+template <class T, std::size_t N = 8>
+class result_vector
+{
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    static constexpr bool relocates_trivially = is_trivially_relocatable_v<T>;
+
+    result_vector() noexcept = default;
+
+    // delegating to the default constructor makes a throwing element copy release the buffer
+    result_vector(std::initializer_list<T> il)
+        : result_vector()
+    {
+        reserve(il.size());
+        for (const T &__v : il)
+        {
+            push_back(__v);
+        }
+    }
+
+    result_vector(const result_vector &other)
+        : result_vector()
+    {
+        reserve(other.m_size);
+        for (const T &__v : other)
+        {
+            std::construct_at(m_data + m_size, __v);
+            ++m_size;
+        }
+    }
+
+    result_vector(result_vector &&other) noexcept(relocates_trivially || std::is_nothrow_move_constructible_v<T>)
+    {
+        __take(other);
+    }
+
+    result_vector &operator=(const result_vector &other)
+    {
+        if (this != std::addressof(other))
+        {
+            result_vector __tmp(other);
+            clear();
+            __take(__tmp);
+        }
+        return *this;
+    }
+
+    result_vector &operator=(result_vector &&other) noexcept(relocates_trivially || std::is_nothrow_move_constructible_v<T>)
+    {
+        if (this != std::addressof(other))
+        {
+            clear();
+            __take(other);
+        }
+        return *this;
+    }
+
+    ~result_vector()
+    {
+        std::destroy(begin(), end());
+        __free();
+    }
+
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    bool empty() const noexcept { return m_size == 0; }
+    static constexpr size_type inline_capacity() noexcept { return N; }
+
+    T *data() noexcept { return m_data; }
+    const T *data() const noexcept { return m_data; }
+
+    iterator begin() noexcept { return m_data; }
+    iterator end() noexcept { return m_data + m_size; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+
+    T &operator[](size_type i) noexcept { return m_data[i]; }
+    const T &operator[](size_type i) const noexcept { return m_data[i]; }
+
+    T &front() noexcept { return m_data[0]; }
+    const T &front() const noexcept { return m_data[0]; }
+    T &back() noexcept { return m_data[m_size - 1]; }
+    const T &back() const noexcept { return m_data[m_size - 1]; }
+
+    void reserve(size_type n)
+    {
+        if (n > m_capacity)
+        {
+            __reallocate(n);
+        }
+    }
+
+    template <class... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (m_size == m_capacity)
+        {
+            // args may refer into this vector, so build the element before moving the others
+            T __tmp(std::forward<Args>(args)...);
+            __reallocate(__grown());
+            return *std::construct_at(m_data + m_size++, std::move(__tmp));
+        }
+        T *__p = std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+        ++m_size;
+        return *__p;
+    }
+
+    void push_back(const T &v) { emplace_back(v); }
+    void push_back(T &&v) { emplace_back(std::move(v)); }
+
+    void pop_back() noexcept
+    {
+        std::destroy_at(m_data + --m_size);
+    }
+
+    void clear() noexcept
+    {
+        std::destroy(begin(), end());
+        m_size = 0;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        T *__p = m_data + (pos - m_data);
+        if constexpr (relocates_trivially)
+        {
+            std::destroy_at(__p);
+            std::memmove(static_cast<void *>(__p), static_cast<const void *>(__p + 1), (end() - __p - 1) * sizeof(T));
+        }
+        else
+        {
+            std::move(__p + 1, end(), __p);
+            std::destroy_at(end() - 1);
+        }
+        --m_size;
+        return __p;
+    }
+
+private:
+    bool __is_inline() const noexcept
+    {
+        return m_data == __inline_data();
+    }
+
+    T *__inline_data() noexcept { return reinterpret_cast<T *>(m_inline); }
+    const T *__inline_data() const noexcept { return reinterpret_cast<const T *>(m_inline); }
+
+    size_type __grown() const noexcept
+    {
+        return std::max<size_type>(m_capacity * 2, 4);
+    }
+
+    static T *__allocate(size_type n)
+    {
+        return std::allocator<T>().allocate(n);
+    }
+
+    void __free() noexcept
+    {
+        if (!__is_inline())
+        {
+            std::allocator<T>().deallocate(m_data, m_capacity);
+        }
+    }
+
+    // moves count elements from src to uninitialized dst and ends their lifetime at src
+    static void __relocate(T *src, size_type count, T *dst)
+    {
+        if constexpr (relocates_trivially)
+        {
+            if (count)
+            {
+                std::memcpy(static_cast<void *>(dst), static_cast<const void *>(src), count * sizeof(T));
+            }
+        }
+        else
+        {
+            std::uninitialized_move(src, src + count, dst);
+            std::destroy(src, src + count);
+        }
+    }
+
+    void __reallocate(size_type n)
+    {
+        T *__new = __allocate(n);
+        auto __guard = detail::make_exception_guard([&] { std::allocator<T>().deallocate(__new, n); });
+        __relocate(m_data, m_size, __new);
+        __guard.__complete();
+
+        __free();
+        m_data = __new;
+        m_capacity = n;
+    }
+
+    // steals a heap buffer, or relocates inline elements; leaves other empty and inline
+    void __take(result_vector &other)
+    {
+        if (other.__is_inline())
+        {
+            __relocate(other.m_data, other.m_size, m_data);
+            m_size = std::exchange(other.m_size, 0);
+            return;
+        }
+        __free();
+        m_data = std::exchange(other.m_data, other.__inline_data());
+        m_size = std::exchange(other.m_size, 0);
+        m_capacity = std::exchange(other.m_capacity, N);
+    }
+
+    alignas(T) std::byte m_inline[(N ? N : 1) * sizeof(T)];
+    T *m_data = __inline_data();
+    size_type m_size = 0;
+    size_type m_capacity = N;
+};
+
+} // namespace gb
@@ -0,0 +1,339 @@
+#pragma once
+#include <bit>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+
+#include "error_catalog.h"
+
+// Status codes for use as E, in place of std::error_code. A domain is a plain class with static
+// members, no virtual functions:
+//
+//   struct http_domain
+//   {
+//       using value_type = int;
+//       static constexpr std::uint64_t id = 0x9b1c54e2d07a3f61; // any unique 64-bit constant
+//       static constexpr const char *name = "http";
+//
+//       static const char *message(int status) noexcept;
+//       static constexpr bool failure(int status) noexcept { return status >= 400; }
+//       static constexpr std::errc generic(int status) noexcept; // std::errc{} if there is none
+//   };
+//
+//   gb::expected<page, gb::status_code<http_domain>> fetch(url u);
+//
+// status_code<Domain> holds only the value and compares in constant expressions. It converts to
+// erased_status_code, 16 bytes: the value and a pointer to a constexpr table of plain function
+// pointers generated once per domain. That is enough to pass codes from different domains through
+// one error type and to test them against each other:
+//
+//   gb::expected<config, gb::erased_status_code> load(path p);
+//
+//   if (r.error() == std::errc::no_such_file_or_directory) // also true for posix_code(ENOENT)
+//
+// Two codes are equivalent if they are equal, or if both domains map them to the same std::errc;
+// the test is a couple of loads and an indirect call, not the virtual equivalent() round trips of
+// std::error_category. message() returns a static string rather than a std::string. generic_code,
+// posix_code and catalog_code (for the error_id of error_catalog.h) are predefined.
+namespace gb {
+
+struct status_domain
+{
+    std::uint64_t id;
+    const char *name;
+    const char *(*message)(std::uint64_t value) noexcept;
+    bool (*failure)(std::uint64_t value) noexcept;
+    std::errc (*generic)(std::uint64_t value) noexcept;
+
+    friend constexpr bool operator==(const status_domain &x, const status_domain &y) noexcept
+    {
+        // the same domain may have one table per shared object
+        return &x == &y || x.id == y.id;
+    }
+};
+
+template <class D>
+concept status_code_domain = requires(const typename D::value_type &v) {
+    { D::id } -> std::convertible_to<std::uint64_t>;
+    { D::name } -> std::convertible_to<const char *>;
+    { D::message(v) } noexcept -> std::same_as<const char *>;
+    { D::failure(v) } -> std::same_as<bool>;
+    { D::generic(v) } -> std::same_as<std::errc>;
+} && std::is_trivially_copyable_v<typename D::value_type> && sizeof(typename D::value_type) <= sizeof(std::uint64_t);
+
+template <class Domain>
+class status_code;
+
+using erased_status_code = status_code<void>;
+
+namespace detail {
+
+template <class V>
+constexpr std::uint64_t __status_to_bits(V v) noexcept
+{
+    if constexpr (std::is_integral_v<V> || std::is_enum_v<V>)
+    {
+        return static_cast<std::uint64_t>(v);
+    }
+    else if constexpr (sizeof(V) == 1)
+    {
+        return std::bit_cast<std::uint8_t>(v);
+    }
+    else if constexpr (sizeof(V) == 2)
+    {
+        return std::bit_cast<std::uint16_t>(v);
+    }
+    else if constexpr (sizeof(V) == 4)
+    {
+        return std::bit_cast<std::uint32_t>(v);
+    }
+    else
+    {
+        static_assert(sizeof(V) == 8, "status code values must be 1, 2, 4 or 8 bytes");
+        return std::bit_cast<std::uint64_t>(v);
+    }
+}
+
+template <class V>
+constexpr V __status_from_bits(std::uint64_t bits) noexcept
+{
+    if constexpr (std::is_integral_v<V> || std::is_enum_v<V>)
+    {
+        return static_cast<V>(bits);
+    }
+    else if constexpr (sizeof(V) == 1)
+    {
+        return std::bit_cast<V>(static_cast<std::uint8_t>(bits));
+    }
+    else if constexpr (sizeof(V) == 2)
+    {
+        return std::bit_cast<V>(static_cast<std::uint16_t>(bits));
+    }
+    else if constexpr (sizeof(V) == 4)
+    {
+        return std::bit_cast<V>(static_cast<std::uint32_t>(bits));
+    }
+    else
+    {
+        return std::bit_cast<V>(bits);
+    }
+}
+
+template <class D>
+struct __status_thunks
+{
+    using __value_t = typename D::value_type;
+
+    static const char *message(std::uint64_t v) noexcept
+    {
+        return D::message(__status_from_bits<__value_t>(v));
+    }
+
+    static bool failure(std::uint64_t v) noexcept
+    {
+        return D::failure(__status_from_bits<__value_t>(v));
+    }
+
+    static std::errc generic(std::uint64_t v) noexcept
+    {
+        return D::generic(__status_from_bits<__value_t>(v));
+    }
+};
+
+// strerror_r is either the XSI one, returning 0 on success, or the GNU one, returning the message
+inline const char *__strerror_text(int r, const char *buffer) noexcept
+{
+    return r == 0 ? buffer : "unknown error";
+}
+
+inline const char *__strerror_text(const char *r, const char *) noexcept
+{
+    return r;
+}
+
+// The message for each errno value below 256, copied once on first use: std::strerror may return
+// a buffer that the next call overwrites, from any thread, so it cannot be handed out as static.
+inline const char *__errno_message(int e) noexcept
+{
+    static constexpr int __count = 256;
+    static constexpr std::size_t __length = 64;
+
+    struct __table
+    {
+        char m_text[__count][__length];
+
+        __table() noexcept
+        {
+            for (int __i = 0; __i < __count; ++__i)
+            {
+                char __buffer[__length] = "";
+#if defined(_WIN32)
+                const char *__s = __strerror_text(::strerror_s(__buffer, __length, __i), __buffer);
+#else
+                const char *__s = __strerror_text(::strerror_r(__i, __buffer, __length), __buffer);
+#endif
+                std::strncpy(m_text[__i], __s, __length - 1);
+                m_text[__i][__length - 1] = '\0';
+            }
+        }
+    };
+
+    static const __table __messages;
+    return e >= 0 && e < __count ? __messages.m_text[e] : "unknown error";
+}
+
+// the table erased codes of domain D point to
+template <status_code_domain D>
+inline constexpr status_domain __status_domain_table{D::id, D::name, &__status_thunks<D>::message,
+                                                     &__status_thunks<D>::failure, &__status_thunks<D>::generic};
+
+} // namespace detail
+
+// std::errc
+struct generic_domain
+{
+    using value_type = std::errc;
+    static constexpr std::uint64_t id = 0x746d6f6c2e2e6765;
+    static constexpr const char *name = "generic";
+
+    // the C library's message, copied once per value
+    static const char *message(std::errc e) noexcept { return detail::__errno_message(static_cast<int>(e)); }
+    static constexpr bool failure(std::errc e) noexcept { return e != std::errc(); }
+    static constexpr std::errc generic(std::errc e) noexcept { return e; }
+};
+
+// errno values
+struct posix_domain
+{
+    using value_type = int;
+    static constexpr std::uint64_t id = 0xa59b4de08c1f3e27;
+    static constexpr const char *name = "posix";
+
+    static const char *message(int e) noexcept { return detail::__errno_message(e); }
+    static constexpr bool failure(int e) noexcept { return e != 0; }
+    // std::errc is defined with the errno values
+    static constexpr std::errc generic(int e) noexcept { return static_cast<std::errc>(e); }
+};
+
+// gb::error_id; catalog errors have no generic equivalent
+struct catalog_domain
+{
+    using value_type = error_id;
+    static constexpr std::uint64_t id = 0x3c0f9e8a61d2b475;
+    static constexpr const char *name = "catalog";
+
+    static const char *message(error_id e) noexcept { return e.message(); }
+    static constexpr bool failure(error_id e) noexcept { return static_cast<bool>(e); }
+    static constexpr std::errc generic(error_id) noexcept { return std::errc(); }
+};
+
+template <class Domain>
+class status_code
+{
+public:
+    static_assert(status_code_domain<Domain>, "Domain must model status_code_domain");
+
+    using domain_type = Domain;
+    using value_type = typename Domain::value_type;
+
+    // success
+    constexpr status_code() noexcept = default;
+
+    constexpr status_code(value_type value) noexcept
+        : m_value(value)
+    {
+    }
+
+    constexpr value_type value() const noexcept { return m_value; }
+
+    static constexpr const status_domain &domain() noexcept { return detail::__status_domain_table<Domain>; }
+
+    const char *message() const noexcept { return Domain::message(m_value); }
+    constexpr bool failure() const noexcept { return Domain::failure(m_value); }
+    constexpr bool success() const noexcept { return !failure(); }
+    constexpr std::errc generic() const noexcept { return Domain::generic(m_value); }
+
+    friend constexpr bool operator==(const status_code &x, const status_code &y) noexcept
+    {
+        return detail::__status_to_bits(x.m_value) == detail::__status_to_bits(y.m_value);
+    }
+
+    friend constexpr bool operator==(const status_code &x, std::errc e) noexcept
+    {
+        return e != std::errc() && x.generic() == e;
+    }
+
+private:
+    value_type m_value = value_type();
+};
+
+template <>
+class status_code<void>
+{
+public:
+    // success, as generic_code()
+    constexpr status_code() noexcept = default;
+
+    template <class Domain>
+    constexpr status_code(const status_code<Domain> &code) noexcept
+        : m_domain(&status_code<Domain>::domain()), m_value(detail::__status_to_bits(code.value()))
+    {
+    }
+
+    constexpr const status_domain &domain() const noexcept { return *m_domain; }
+    constexpr std::uint64_t value() const noexcept { return m_value; }
+
+    const char *message() const noexcept { return m_domain->message(m_value); }
+    bool failure() const noexcept { return m_domain->failure(m_value); }
+    bool success() const noexcept { return !failure(); }
+    std::errc generic() const noexcept { return m_domain->generic(m_value); }
+
+    template <class Domain>
+    constexpr bool is() const noexcept
+    {
+        return *m_domain == status_code<Domain>::domain();
+    }
+
+    // the typed code; requires is<Domain>()
+    template <class Domain>
+    constexpr status_code<Domain> to() const noexcept
+    {
+        return status_code<Domain>(detail::__status_from_bits<typename Domain::value_type>(m_value));
+    }
+
+    // equal, or mapped to the same std::errc by their domains
+    friend bool operator==(const status_code &x, const status_code &y) noexcept
+    {
+        if (*x.m_domain == *y.m_domain)
+        {
+            return x.m_value == y.m_value;
+        }
+        const std::errc __e = x.generic();
+        return __e != std::errc() && __e == y.generic();
+    }
+
+    friend bool operator==(const status_code &x, std::errc e) noexcept
+    {
+        return e != std::errc() && x.generic() == e;
+    }
+
+private:
+    const status_domain *m_domain = &detail::__status_domain_table<generic_domain>;
+    std::uint64_t m_value = 0;
+};
+
+using generic_code = status_code<generic_domain>;
+using posix_code = status_code<posix_domain>;
+using catalog_code = status_code<catalog_domain>;
+
+// the code in errno
+inline posix_code errno_code() noexcept
+{
+    return posix_code(errno);
+}
+
+} // namespace gb
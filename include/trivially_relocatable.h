@@ -0,0 +1,62 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+
+#include "boxed_error.h"
+#include "expected_base.h"
+
+namespace gb {
+
+// A type is trivially relocatable when moving an object to a new address and ending the
+// lifetime of the original can be done by copying its bytes, even if its move constructor and
+// destructor are not trivial. Containers use this to grow with memcpy.
+//
+// Every trivially copyable type qualifies. Other types opt in by specializing the trait:
+//
+//   template<> struct gb::is_trivially_relocatable<my_handle> : std::true_type {};
+//
+// Only do so for types that hold no pointer into themselves. std::string is deliberately left
+// out: the libstdc++ small string points into its own buffer.
+template <class T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>>
+{
+};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template <class T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type
+{
+};
+
+template <class T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type
+{
+};
+
+template <class E>
+struct is_trivially_relocatable<boxed_error<E>> : std::true_type
+{
+};
+
+namespace detail {
+
+template <class T>
+inline constexpr bool __relocatable_or_void = std::is_void_v<T> || is_trivially_relocatable_v<T>;
+
+} // namespace detail
+
+// expected is a discriminant next to a T or an E, void standing for no payload
+template <class T, class E>
+struct is_trivially_relocatable<expected<T, E>>
+    : std::bool_constant<detail::__relocatable_or_void<T> && detail::__relocatable_or_void<E>>
+{
+};
+
+template <class E>
+struct is_trivially_relocatable<unexpected<E>> : std::bool_constant<detail::__relocatable_or_void<E>>
+{
+};
+
+} // namespace gb
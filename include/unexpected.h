@@ -1,5 +1,9 @@
 #pragma once
+#include <initializer_list>
 #include <type_traits>
+#include <utility>
+
+#include "error_trace.h"
 
 namespace gb {
 
@@ -158,25 +162,68 @@ public:
     static_assert(!std::is_same<E, void>::value, "E must not be void");
 
     unexpected() = delete;
-    constexpr explicit unexpected(const E& e)
+    constexpr explicit unexpected(const E& e GB_EXPECTED_TRACE_PARAM)
         : m_val{e}
     {
+        GB_EXPECTED_TRACE(created);
     }
 
-    constexpr explicit unexpected(E&& e)
+    constexpr explicit unexpected(E&& e GB_EXPECTED_TRACE_PARAM)
         : m_val{std::move(e)}
     {
+        GB_EXPECTED_TRACE(created);
+    }
+
+    // A defaulted parameter cannot follow a pack, so the arguments are spelled out up to three
+    // (and a list plus one) for the error trace to record the call site; longer argument lists
+    // take the packs below and record no call site.
+    template<class U, typename std::enable_if<std::is_constructible<E, U&&>::value>::type* = nullptr>
+    constexpr explicit unexpected(U&& u GB_EXPECTED_TRACE_PARAM)
+        : m_val{std::forward<U>(u)}
+    {
+        GB_EXPECTED_TRACE(created);
+    }
+
+    template<class U1, class U2, typename std::enable_if<std::is_constructible<E, U1&&, U2&&>::value>::type* = nullptr>
+    constexpr explicit unexpected(U1&& u1, U2&& u2 GB_EXPECTED_TRACE_PARAM)
+        : m_val(std::forward<U1>(u1), std::forward<U2>(u2))
+    {
+        GB_EXPECTED_TRACE(created);
     }
 
-    template<class... Args, typename std::enable_if<std::is_constructible<E, Args&&...>::value>::type* = nullptr>
+    template<class U1, class U2, class U3, typename std::enable_if<std::is_constructible<E, U1&&, U2&&, U3&&>::value>::type* = nullptr>
+    constexpr explicit unexpected(U1&& u1, U2&& u2, U3&& u3 GB_EXPECTED_TRACE_PARAM)
+        : m_val(std::forward<U1>(u1), std::forward<U2>(u2), std::forward<U3>(u3))
+    {
+        GB_EXPECTED_TRACE(created);
+    }
+
+    template<class... Args, typename std::enable_if<(sizeof...(Args) > 3) && std::is_constructible<E, Args&&...>::value>::type* = nullptr>
     constexpr explicit unexpected(Args&&... args)
-        : m_val{std::forward<Args>(args)...}
+        : m_val(std::forward<Args>(args)...)
     {
+        GB_EXPECTED_TRACE_AT(::std::source_location(), created); // call site unknown
     }
-    template<class U, class... Args, typename std::enable_if<std::is_constructible<E, std::initializer_list<U>&, Args&&...>::value>::type* = nullptr>
+
+    template<class U, typename std::enable_if<std::is_constructible<E, std::initializer_list<U>&>::value>::type* = nullptr>
+    constexpr explicit unexpected(std::initializer_list<U> l GB_EXPECTED_TRACE_PARAM)
+        : m_val(l)
+    {
+        GB_EXPECTED_TRACE(created);
+    }
+
+    template<class U, class V, typename std::enable_if<std::is_constructible<E, std::initializer_list<U>&, V&&>::value>::type* = nullptr>
+    constexpr explicit unexpected(std::initializer_list<U> l, V&& v GB_EXPECTED_TRACE_PARAM)
+        : m_val(l, std::forward<V>(v))
+    {
+        GB_EXPECTED_TRACE(created);
+    }
+
+    template<class U, class... Args, typename std::enable_if<(sizeof...(Args) > 1) && std::is_constructible<E, std::initializer_list<U>&, Args&&...>::value>::type* = nullptr>
     constexpr explicit unexpected(std::initializer_list<U> l, Args&&... args)
-        : m_val{l, std::forward<Args>(args)...}
+        : m_val(l, std::forward<Args>(args)...)
     {
+        GB_EXPECTED_TRACE_AT(::std::source_location(), created); // call site unknown
     }
 
     constexpr const E& error() const& { return m_val; }
@@ -195,6 +242,30 @@ struct unexpected_void
     constexpr explicit unexpected_void(do_not_use, do_not_use) noexcept {}
 };
 
+namespace detail {
+
+#if GB_EXPECTED_ERROR_TRACE
+// The unexpect tag as the expected(unexpect, args...) constructors take it: converting the tag
+// captures the call site, which a defaulted parameter after the pack could not.
+struct __unexpect_at
+{
+    constexpr __unexpect_at(unexpected_void, std::source_location where = std::source_location::current()) noexcept
+        : m_where(where)
+    {
+    }
+
+    std::source_location m_where;
+};
+
+#define GB_EXPECTED_TRACE_UNEXPECT(tag) GB_EXPECTED_TRACE_AT((tag).m_where, created)
+#else
+using __unexpect_at = unexpected_void;
+
+#define GB_EXPECTED_TRACE_UNEXPECT(tag) ((void)(tag))
+#endif
+
+} // namespace detail
+
 struct expected_void
 {
     struct do_not_use {};
@@ -1,5 +1,24 @@
 #include "expected.h"
 #include <iostream>
+#include <string>
+#include <system_error>
+
+struct node { int id; };
+template <> inline constexpr bool gb::niche_pointee<node> = true;
+
+// the discriminant lives in the free low bit of the pointer
+static_assert(sizeof(expected<node*, std::errc>) == sizeof(node*));
+static_assert(sizeof(optional<node*>) == sizeof(node*));
+static_assert(sizeof(with_error<const node*>) == sizeof(node*));
+
+// trivially copyable payloads keep expected trivially copyable
+static_assert(std::is_trivially_copyable_v<expected<int, int>>);
+static_assert(std::is_trivially_copyable_v<expected<int, void>>);
+static_assert(std::is_trivially_copy_assignable_v<expected<int, int>>);
+static_assert(std::is_trivially_move_assignable_v<expected<int, int>>);
+static_assert(std::is_trivially_copyable_v<with_error<int>>);
+static_assert(std::is_trivially_copyable_v<boolean>);
+static_assert(!std::is_trivially_copyable_v<expected<std::string, int>>);
 
 int main()
 {
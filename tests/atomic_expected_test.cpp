@@ -0,0 +1,188 @@
+#undef NDEBUG
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "atomic_expected.h"
+
+// 24 bytes whose fields agree with each other, so a torn read shows up as a broken invariant
+struct triple
+{
+    std::uint64_t a, b, c;
+
+    static triple of(std::uint64_t k) noexcept { return {k, ~k, k * 3}; }
+    bool consistent() const noexcept { return b == ~a && c == a * 3; }
+
+    friend bool operator==(const triple &, const triple &) = default;
+};
+
+// 12 bytes with padding: compared with operator==, not bitwise
+struct padded
+{
+    std::uint32_t x;
+    std::uint64_t y;
+
+    friend bool operator==(const padded &, const padded &) = default;
+};
+
+using wide = gb::expected<triple, std::uint64_t>;
+
+static_assert(!gb::atomic_expected<triple, std::uint64_t>::is_always_lock_free);
+static_assert(!gb::atomic_expected<padded, int>::is_always_lock_free);
+static_assert(gb::atomic_expected<std::uint32_t, std::uint16_t>::is_always_lock_free);
+
+constexpr int threads = 4;
+constexpr int rounds = 20000;
+
+// readers never see half of one write and half of another, values or errors
+static void test_no_torn_reads()
+{
+    gb::atomic_expected<triple, std::uint64_t> cell(wide(std::in_place, triple::of(0)));
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t)
+    {
+        writers.emplace_back([&, t] {
+            for (std::uint64_t i = 1; i <= rounds; ++i)
+            {
+                const std::uint64_t k = i * 2 + t;
+                cell.store(k % 5 ? wide(std::in_place, triple::of(k)) : wide(gb::unexpect, k));
+            }
+        });
+    }
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; ++t)
+    {
+        readers.emplace_back([&] {
+            for (int i = 0; i < rounds; ++i)
+            {
+                const wide e = cell.load();
+                assert(e ? e->consistent() : e.error() % 5 == 0);
+            }
+        });
+    }
+
+    for (auto &w : writers)
+    {
+        w.join();
+    }
+    for (auto &r : readers)
+    {
+        r.join();
+    }
+}
+
+// compare_exchange under contention loses no increment
+static void test_compare_exchange_counter()
+{
+    gb::atomic_expected<triple, std::uint64_t> cell(wide(std::in_place, triple::of(0)));
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&] {
+            for (int i = 0; i < rounds; ++i)
+            {
+                wide seen = cell.load();
+                while (!cell.compare_exchange_weak(seen, wide(std::in_place, triple::of(seen->a + 1))))
+                {
+                    assert(seen && seen->consistent());
+                }
+            }
+        });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+    assert(cell.load() == wide(std::in_place, triple::of(std::uint64_t{threads} * rounds)));
+
+    // a failed compare_exchange reports the current value and leaves it alone
+    wide stale(gb::unexpect, 7);
+    assert(!cell.compare_exchange_strong(stale, wide(gb::unexpect, 8)));
+    assert(stale == cell.load());
+}
+
+// every value stored by exchange comes back exactly once, from a later exchange or at the end
+static void test_exchange()
+{
+    gb::atomic_expected<triple, std::uint64_t> cell(wide(gb::unexpect, 0));
+
+    std::vector<std::vector<std::uint64_t>> returned(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t] {
+            for (std::uint64_t i = 0; i < rounds; ++i)
+            {
+                const std::uint64_t k = 1 + t * std::uint64_t{rounds} + i;
+                const wide old = cell.exchange(k % 2 ? wide(std::in_place, triple::of(k)) : wide(gb::unexpect, k));
+                assert(!old || old->consistent());
+                returned[t].push_back(old ? old->a : old.error());
+            }
+        });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+
+    std::vector<std::uint64_t> all;
+    for (const auto &r : returned)
+    {
+        all.insert(all.end(), r.begin(), r.end());
+    }
+    const wide last = cell.load();
+    all.push_back(last ? last->a : last.error());
+    std::sort(all.begin(), all.end());
+    for (std::uint64_t i = 0; i < all.size(); ++i)
+    {
+        assert(all[i] == i);
+    }
+}
+
+// equal values with different padding bytes still compare equal
+static void test_padded_compare()
+{
+    using holey = gb::expected<padded, int>;
+
+    padded p;
+    std::memset(&p, 0xff, sizeof(p));
+    p.x = 1;
+    p.y = 2;
+    gb::atomic_expected<padded, int> cell(holey(std::in_place, p));
+
+    holey exp(std::in_place, padded{1, 2});
+    assert(cell.compare_exchange_strong(exp, holey(gb::unexpect, 3)));
+    assert(cell.load() == holey(gb::unexpect, 3));
+}
+
+// wait returns once another thread has stored a different value
+static void test_wait()
+{
+    gb::atomic_expected<triple, std::uint64_t> cell(wide(gb::unexpect, 1));
+    std::atomic<bool> woke{false};
+
+    std::thread waiter([&] {
+        cell.wait(wide(gb::unexpect, 1));
+        woke = true;
+    });
+    cell.store(wide(std::in_place, triple::of(2)));
+    cell.notify_all();
+    waiter.join();
+    assert(woke && cell.load()->a == 2);
+}
+
+int main()
+{
+    test_no_torn_reads();
+    test_compare_exchange_counter();
+    test_exchange();
+    test_padded_compare();
+    test_wait();
+}
@@ -0,0 +1,116 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "boolean_set.h"
+
+// bits past size() stay zero whatever the set went through, so words() can be consumed as is
+static void test_tail_bits_masked()
+{
+    gb::boolean_set s(70, gb::expected<void, void>(gb::expect));
+    assert(s.size() == 70 && s.all() && s.count() == 70);
+    assert(s.words().size() == 2 && s.words()[1] == 0x3f);
+
+    s.resize(65);
+    assert(s.words()[1] == 0x1);
+    s.resize(130, gb::expected<void, void>(gb::expect));
+    assert(s.count() == 130 && s.words().size() == 3 && s.words()[2] == 0x3);
+
+    s.pop_back();
+    assert(s.size() == 129 && s.words()[2] == 0x1);
+
+    s.flip();
+    assert(s.none() && s.words()[2] == 0);
+    s = ~s;
+    assert(s.all() && s.words()[2] == 0x1);
+
+    // shrinking and growing again does not bring back the old bits
+    s.resize(3);
+    s.resize(64);
+    assert(s.count() == 3 && s.words().size() == 1 && s.words()[0] == 0x7);
+    s.push_back(false);
+    assert(s.words().size() == 2 && s.words()[1] == 0);
+    s.push_back(true);
+    assert(s.words()[1] == 0x2 && s.count() == 4);
+}
+
+static void test_set_operations()
+{
+    gb::boolean_set a(67), b(67);
+    for (std::size_t i = 0; i < 67; ++i)
+    {
+        a[i] = i % 2 == 0;
+        b[i] = i % 3 == 0;
+    }
+
+    const auto both = a & b;
+    const auto either = a | b;
+    const auto one = a ^ b;
+    for (std::size_t i = 0; i < 67; ++i)
+    {
+        assert(both.test(i) == (i % 6 == 0));
+        assert(either.test(i) == (i % 2 == 0 || i % 3 == 0));
+        assert(one.test(i) == ((i % 2 == 0) != (i % 3 == 0)));
+    }
+    assert(((~a).words()[1] >> 3) == 0);
+    assert((a | ~a).all() && (a & ~a).none());
+    assert(a != b && (a & a) == a);
+}
+
+// failures() lists the no elements in increasing order, across words
+static void test_failures()
+{
+    gb::boolean_set s(200, gb::expected<void, void>(gb::expect));
+    const std::vector<std::size_t> failed{0, 63, 64, 65, 127, 128, 199};
+    for (std::size_t i : failed)
+    {
+        s[i] = gb::expected<void, void>(gb::unexpect);
+    }
+    assert(s.count_failed() == failed.size());
+
+    std::vector<std::size_t> seen;
+    for (std::size_t i : s.failures())
+    {
+        seen.push_back(i);
+    }
+    assert(seen == failed);
+    assert(s.find_failure(1) == 63 && s.find_failure(129) == 199);
+
+    // none failed, and all failed
+    gb::boolean_set ok(100, gb::expected<void, void>(gb::expect));
+    assert(ok.failures().begin() == ok.failures().end() && ok.find_failure() == 100);
+
+    gb::boolean_set bad(66);
+    std::size_t n = 0;
+    for (std::size_t i : bad.failures())
+    {
+        assert(i == n++);
+    }
+    assert(n == 66);
+
+    gb::boolean_set none;
+    assert(none.failures().begin() == none.failures().end() && none.all());
+}
+
+static void test_reference()
+{
+    gb::boolean_set s(3);
+    s[1] = true;
+    assert(s[1].has_value() && !s[0]);
+    s[2] = s[1];
+    assert(s.test(2));
+
+    const gb::boolean_set &c = s;
+    assert(c[2].has_value() && !c[0].has_value());
+    gb::expected<void, void> e = s[0];
+    assert(!e);
+}
+
+int main()
+{
+    test_tail_bits_masked();
+    test_set_operations();
+    test_failures();
+    test_reference();
+}
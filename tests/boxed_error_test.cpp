@@ -0,0 +1,57 @@
+#undef NDEBUG
+#include <cassert>
+#include <string>
+#include <utility>
+
+#include "boxed_error.h"
+#include "expected.h"
+
+using box = gb::boxed_error<std::string>;
+
+// a moved-from box is empty: it compares, assigns and destroys without touching the error
+static void test_moved_from_box()
+{
+    box a(std::string(64, 'a'));
+    box b(std::move(a));
+    assert(a.empty() && !b.empty());
+    assert(*b == std::string(64, 'a'));
+
+    assert(!(a == b) && !(b == a));
+    assert(!(a == std::string()));
+    box c(std::move(b));
+    assert(a == b); // both empty
+
+    a = c;
+    assert(!a.empty() && a == c);
+    b = std::move(c);
+    assert(b == a && c.empty());
+}
+
+static void test_copy_of_empty_box()
+{
+    box a("x");
+    box b(std::move(a));
+    box c(a);
+    assert(c.empty());
+    c = b;
+    assert(c == "x");
+}
+
+// expected<T, boxed_error<E>> reaches E through the box
+static void test_in_expected()
+{
+    gb::expected<int, box> r(gb::unexpect, std::string("failed"));
+    assert(!r && r.error() == "failed");
+    const std::string &e = r.error();
+    assert(e.size() == 6);
+
+    auto moved = std::move(r);
+    assert(moved.error() == "failed");
+}
+
+int main()
+{
+    test_moved_from_box();
+    test_copy_of_empty_box();
+    test_in_expected();
+}
@@ -0,0 +1,124 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "error_arena.h"
+#include "expected.h"
+
+#define TEST_ERRORS(X) X(bad_input, "bad input") X(io_failed, "i/o failed", fatal)
+GB_DEFINE_ERROR_DOMAIN(test, 1, TEST_ERRORS);
+
+// a scope rewinds its arena: the next scope reuses the same bytes
+static void test_scope_rewinds()
+{
+    gb::error_arena arena;
+    const char *first = nullptr;
+    {
+        gb::error_arena::scope s(arena);
+        gb::arena_error e(test::bad_input, "first");
+        first = e.message();
+        gb::arena_error(test::bad_input, "second");
+    }
+    {
+        gb::error_arena::scope s(arena);
+        gb::arena_error e(test::bad_input, "again");
+        assert(e.message() == first);
+        assert(std::strcmp(e.message(), "again") == 0);
+    }
+
+    // scopes nest, and the outer scope's errors survive the inner one
+    gb::error_arena::scope outer(arena);
+    gb::arena_error kept(test::bad_input, "kept");
+    {
+        gb::error_arena::scope inner(arena);
+        gb::arena_error(test::bad_input, std::string(100, 'x'));
+    }
+    assert(kept.message_view() == "kept");
+}
+
+// errors past a chunk's end go to a new chunk, and the chunks are kept for the next scope
+static void test_chunk_growth()
+{
+    gb::error_arena arena(128);
+    std::vector<gb::arena_error> errors;
+    {
+        gb::error_arena::scope s(arena);
+        for (int i = 0; i < 20; ++i)
+        {
+            errors.emplace_back(test::bad_input, std::string(40, static_cast<char>('a' + i)));
+        }
+        for (int i = 0; i < 20; ++i)
+        {
+            assert(errors[i].message_view() == std::string(40, static_cast<char>('a' + i)));
+        }
+
+        // larger than a chunk: a chunk of its own
+        gb::arena_error big(test::bad_input, std::string(1000, 'z'));
+        assert(big.message_view().size() == 1000);
+    }
+    errors.clear();
+
+    const std::size_t grown = arena.capacity();
+    assert(grown >= 20 * 40 + 1000);
+    {
+        gb::error_arena::scope s(arena);
+        for (int i = 0; i < 20; ++i)
+        {
+            gb::arena_error(test::bad_input, std::string(40, 'b'));
+        }
+        gb::arena_error(test::bad_input, std::string(1000, 'z'));
+    }
+    assert(arena.capacity() == grown);
+}
+
+static void test_format_and_context()
+{
+    gb::error_arena arena;
+    gb::error_arena::scope s(arena);
+
+    auto e = gb::arena_error::format(test::io_failed, "reading %s line %d", "a.conf", 12);
+    assert(e.message_view() == "reading a.conf line 12");
+    assert(e.code() == test::io_failed && e.code().severity() == gb::error_severity::fatal);
+
+    // past the 256 byte buffer: formatted a second time, straight into the arena
+    const std::string long_text(300, 'q');
+    auto l = gb::arena_error::format(test::bad_input, "<%s>", long_text.c_str());
+    assert(l.message_view() == "<" + long_text + ">");
+
+    auto chained = e.with_context("loading config").with_context(test::bad_input, "starting");
+    std::vector<std::string> messages;
+    std::vector<gb::error_id> codes;
+    chained.for_each([&](const gb::arena_error &link) {
+        messages.emplace_back(link.message());
+        codes.push_back(link.code());
+    });
+    assert((messages == std::vector<std::string>{"starting", "loading config", "reading a.conf line 12"}));
+    assert(codes[0] == test::bad_input && codes[1] == test::io_failed && codes[2] == test::io_failed);
+    assert(chained.cause().cause().message() == e.message());
+    assert(e.cause().empty());
+
+    gb::expected<int, gb::arena_error> r(gb::unexpect, e);
+    auto with = r.transform_error([](gb::arena_error x) { return x.with_context("outer"); });
+    assert(with.error().message_view() == "outer" && with.error().cause().message() == e.message());
+}
+
+// a format that fails leaves an empty message, not the buffer's garbage
+static void test_format_failure()
+{
+    gb::error_arena arena;
+    gb::error_arena::scope s(arena);
+    const wchar_t unencodable[] = {static_cast<wchar_t>(0x10FFFF), 0}; // not representable in the C locale
+    auto e = gb::arena_error::format(test::bad_input, "%ls", unencodable);
+    assert(e.message()[0] == '\0' && e.message_view().empty());
+    assert(e.code() == test::bad_input);
+}
+
+int main()
+{
+    test_scope_rewinds();
+    test_chunk_growth();
+    test_format_and_context();
+    test_format_failure();
+}
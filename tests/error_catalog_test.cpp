@@ -0,0 +1,102 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+
+#include "error_catalog.h"
+#include "expected.h"
+
+#define IO_ERRORS(X) X(not_found, "file not found", warning) X(denied, "permission denied") X(corrupt, "bad checksum", fatal)
+#define NET_ERRORS(X) X(timeout, "timed out", info) X(refused, "connection refused")
+
+GB_DEFINE_ERROR_DOMAIN(io, 1, IO_ERRORS);
+GB_DEFINE_ERROR_DOMAIN(net, 255, NET_ERRORS);
+
+static_assert(std::is_trivially_copyable_v<gb::error_id> && sizeof(gb::error_id) == 4);
+static_assert(sizeof(gb::expected<int *, gb::error_id>) == sizeof(int *));
+
+// the table is available at compile time, entry 0 being "no error"
+static_assert(static_cast<int>(io::not_found) == 1 && static_cast<int>(net::refused) == 2);
+static_assert(gb::describe(io::corrupt).severity == gb::error_severity::fatal);
+static_assert(gb::describe(net::timeout).severity == gb::error_severity::info);
+static_assert(gb::error_id(net::refused).domain_id() == 255 && gb::error_id(net::refused).code() == 2);
+static_assert(gb::error_id(io::denied).is<io>() && !gb::error_id(io::denied).is<net>());
+
+static bool same(const char *a, const char *b)
+{
+    return std::strcmp(a, b) == 0;
+}
+
+// both domains entered the registry before main, and their errors are looked up through it
+static void test_registry()
+{
+    assert(gb::detail::__error_domains[1].load() == &__gb_error_domain(io::not_found));
+    assert(gb::detail::__error_domains[255].load() == &__gb_error_domain(net::timeout));
+    assert(gb::detail::__error_domains[2].load() == nullptr);
+
+    const gb::error_id e = io::corrupt;
+    assert(same(e.domain_name(), "io") && same(e.name(), "corrupt") && same(e.message(), "bad checksum"));
+    assert(&e.info() == &gb::describe(io::corrupt));
+
+    const gb::error_id n = net::refused;
+    assert(same(n.domain_name(), "net") && same(n.name(), "refused") && same(n.message(), "connection refused"));
+    assert(e != n && n == gb::error_id(net::refused));
+
+    // entering a domain again is harmless
+    assert(gb::detail::__register_error_domain(__gb_error_domain(io::not_found)));
+}
+
+// the severity given in the catalog, error when none is given
+static void test_severity()
+{
+    assert(gb::error_id(io::not_found).severity() == gb::error_severity::warning);
+    assert(gb::error_id(io::denied).severity() == gb::error_severity::error);
+    assert(gb::error_id(io::corrupt).severity() == gb::error_severity::fatal);
+    assert(gb::error_id(net::timeout).severity() == gb::error_severity::info);
+    assert(gb::error_id(net::refused).severity() == gb::error_severity::error);
+}
+
+// no error, an unregistered domain and a code past the table each have their own entry
+static void test_unknown()
+{
+    const gb::error_id none;
+    assert(!none && same(none.name(), "none") && none.severity() == gb::error_severity::info);
+
+    const auto stray = gb::error_id::from_raw(2u << gb::error_id::code_bits | 1);
+    assert(stray && same(stray.domain_name(), "unknown") && same(stray.message(), "unknown error"));
+
+    const auto past = gb::error_id::from_raw(1u << gb::error_id::code_bits | 4);
+    assert(same(past.domain_name(), "io") && same(past.name(), "unknown"));
+    assert(past.severity() == gb::error_severity::error);
+
+    // the raw value round-trips
+    assert(gb::error_id::from_raw(gb::error_id(net::timeout).raw()) == gb::error_id(net::timeout));
+}
+
+static gb::expected<int *, gb::error_id> find(int *p)
+{
+    if (!p)
+    {
+        return gb::unexpected<gb::error_id>(io::not_found);
+    }
+    return p;
+}
+
+// the error rides in the pointer's niche and keeps its catalog entry
+static void test_in_expected()
+{
+    int x = 1;
+    assert(find(&x) && *find(&x) == &x);
+
+    const auto r = find(nullptr);
+    assert(!r && r.error() == gb::error_id(io::not_found));
+    assert(same(r.error().message(), "file not found") && r.error().severity() == gb::error_severity::warning);
+}
+
+int main()
+{
+    test_registry();
+    test_severity();
+    test_unknown();
+    test_in_expected();
+}
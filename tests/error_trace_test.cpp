@@ -0,0 +1,74 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "expected.h"
+
+// built with GB_EXPECTED_ERROR_TRACE=1
+
+struct event
+{
+    gb::error_trace_event kind;
+    unsigned line;
+};
+
+static std::vector<event> recorded()
+{
+    std::vector<event> __events;
+    gb::for_each_error_trace([&](const gb::error_trace_entry &e) {
+        assert(std::strstr(e.where.file_name(), "error_trace_test.cpp") != nullptr);
+        __events.push_back({e.event, static_cast<unsigned>(e.where.line())});
+    });
+    return __events;
+}
+
+// every way of making an error records "created" at the line that made it
+static void test_created_at_call_site()
+{
+    gb::clear_error_trace();
+    const unsigned first = __LINE__ + 1;
+    gb::unexpected<int> a(1);
+    gb::unexpected<std::string> b(3, 'x');
+    gb::unexpected<std::vector<int>> c({1, 2});
+    gb::expected<int, int> d(gb::unexpect);
+    gb::expected<int, std::string> e(gb::unexpect, 2, 'y');
+    gb::expected<int, std::vector<int>> f(gb::unexpect, {1, 2, 3});
+    gb::expected<void, int> g(gb::unexpect, 7);
+    gb::expected<int, void> h(gb::unexpect);
+    gb::expected<int *, int> i(gb::unexpect, 4);
+
+    auto events = recorded();
+    assert(events.size() == 9);
+    for (unsigned k = 0; k < events.size(); ++k)
+    {
+        assert(events[k].kind == gb::error_trace_event::created);
+        assert(events[k].line == first + k);
+    }
+    assert(a.error() == 1 && b.error() == "xxx" && c.error().size() == 2);
+    assert(e.error() == "yy" && f.error().size() == 3 && g.error() == 7 && i.error() == 4);
+    (void)d, (void)h;
+}
+
+// an error met by and_then is propagated, and or_else handles it
+static void test_propagated_and_handled()
+{
+    gb::expected<int, int> r(gb::unexpect, 1);
+    gb::clear_error_trace();
+    const unsigned first = __LINE__ + 1;
+    auto p = r.and_then([](int v) { return gb::expected<int, int>(std::in_place, v); });
+    auto q = p.or_else([](int) { return gb::expected<int, int>(std::in_place, 0); });
+    assert(q && *q == 0);
+
+    auto events = recorded();
+    assert(events.size() == 2);
+    assert(events[0].kind == gb::error_trace_event::propagated && events[0].line == first);
+    assert(events[1].kind == gb::error_trace_event::handled && events[1].line == first + 1);
+}
+
+int main()
+{
+    test_created_at_call_site();
+    test_propagated_and_handled();
+}
@@ -0,0 +1,121 @@
+#undef NDEBUG
+#include <cassert>
+#include <list>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "expected_algorithms.h"
+
+using result = gb::expected<std::string, int>;
+
+static std::vector<result> batch()
+{
+    return {result(std::string(40, 'a')), result(std::string(40, 'b')), result(gb::unexpect, 7),
+            result(std::string(40, 'c'))};
+}
+
+// inputs the caller still owns are copied from
+static void test_borrowed_inputs_are_not_moved()
+{
+    std::vector<result> v = batch();
+    v.erase(v.begin() + 2);
+
+    auto all = gb::collect(std::span(v));
+    assert(all && all->size() == 3 && *v[0] == std::string(40, 'a'));
+
+    auto first = gb::collect(v | std::views::take(1));
+    assert(first && (*first)[0] == std::string(40, 'a') && *v[0] == std::string(40, 'a'));
+
+    std::string out[3];
+    auto written = gb::collect_into(std::span(v), std::span(out));
+    assert(written && written->size() == 3 && *v[1] == std::string(40, 'b'));
+
+    std::vector<result> mixed = batch();
+    std::string values[4];
+    gb::indexed_error<int> errors[4];
+    auto parts = gb::partition_results(std::span(mixed), std::span(values), std::span(errors));
+    assert(parts.values.size() == 3 && parts.errors.size() == 1 && parts.errors[0].index == 2);
+    assert(*mixed[0] == std::string(40, 'a') && *mixed[3] == std::string(40, 'c'));
+
+    parts = gb::partition_results(mixed | std::views::drop(1), std::span(values), std::span(errors));
+    assert(parts.values.size() == 2 && parts.errors[0].index == 1 && *mixed[1] == std::string(40, 'b'));
+}
+
+// an owning rvalue range is still moved from
+static void test_owning_rvalue_is_moved()
+{
+    std::vector<result> v = batch();
+    v.erase(v.begin() + 2);
+    auto all = gb::collect(std::move(v));
+    assert(all && all->size() == 3 && (*all)[2] == std::string(40, 'c'));
+}
+
+static void test_short_buffers_are_not_overrun()
+{
+    std::vector<result> v = batch();
+    v.erase(v.begin() + 2);
+
+    std::string two[2];
+    bool threw = false;
+    try
+    {
+        (void)gb::collect_into(v, std::span(two));
+    }
+    catch (const std::length_error &)
+    {
+        threw = true;
+    }
+    assert(threw && two[0].empty()); // sized input: rejected before anything is written
+
+    // unsized input: stops when the buffer is full
+    std::list<result> l(v.begin(), v.end());
+    auto unsized = l | std::views::filter([](const result &) { return true; });
+    threw = false;
+    try
+    {
+        (void)gb::collect_into(unsized, std::span(two));
+    }
+    catch (const std::length_error &)
+    {
+        threw = true;
+    }
+    assert(threw && two[1] == std::string(40, 'b'));
+
+    std::vector<result> mixed = batch();
+    std::string values[4];
+    gb::indexed_error<int> no_errors[1];
+    auto parts = gb::partition_results(std::span(mixed).first(2), std::span(values), std::span(no_errors).first(0));
+    assert(parts.values.size() == 2 && parts.errors.empty());
+
+    threw = false;
+    try
+    {
+        (void)gb::partition_results(mixed, std::span(values), std::span(no_errors).first(0));
+    }
+    catch (const std::length_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+
+    threw = false;
+    try
+    {
+        (void)gb::partition_results(mixed, std::span(values).first(2), std::span(no_errors));
+    }
+    catch (const std::length_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+int main()
+{
+    test_borrowed_inputs_are_not_moved();
+    test_owning_rvalue_is_moved();
+    test_short_buffers_are_not_overrun();
+}
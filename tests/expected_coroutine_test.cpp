@@ -0,0 +1,46 @@
+#undef NDEBUG
+#include <cassert>
+#include <string>
+
+#include "expected_coroutine.h"
+
+static gb::expected<int, std::string> parse(int v)
+{
+    if (v < 0)
+    {
+        return gb::unexpected<std::string>("negative");
+    }
+    return v;
+}
+
+static gb::expected<int, std::string> sum(int a, int b)
+{
+    int x = co_await parse(a);
+    int y = co_await parse(b);
+    co_return x + y;
+}
+
+static gb::expected<int, std::string> nested(int a)
+{
+    int s = co_await sum(a, a);
+    co_return s * 10;
+}
+
+// the result is there by the time the caller converts the return object
+static void test_result_reaches_caller()
+{
+    auto ok = sum(2, 3);
+    assert(ok && *ok == 5);
+
+    auto failed = sum(2, -1);
+    assert(!failed && failed.error() == "negative");
+
+    gb::expected<int, std::string> n = nested(4);
+    assert(n && *n == 80);
+    assert(nested(-4).error() == "negative");
+}
+
+int main()
+{
+    test_result_reaches_caller();
+}
@@ -0,0 +1,57 @@
+#undef NDEBUG
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+
+#include "expected_future.h"
+
+static bool broken(gb::future<int, int> f)
+{
+    try
+    {
+        (void)std::move(f).get();
+    }
+    catch (const gb::bad_expect_access<void> &)
+    {
+        return true;
+    }
+    return false;
+}
+
+// a throwing continuation breaks the next future, on the producer thread or right away
+static void test_throwing_then_breaks_next()
+{
+    auto thrower = [](int) -> int { throw std::runtime_error("boom"); };
+
+    gb::promise<int, int> p;
+    auto g = p.get_future().then(thrower);
+    std::thread producer([&] { p.set_value(1); });
+    producer.join();
+    assert(broken(std::move(g)));
+
+    gb::promise<int, int> q;
+    auto f = q.get_future();
+    q.set_value(1);
+    assert(broken(std::move(f).then(thrower)));
+
+    // later links of the chain see the break
+    gb::promise<int, int> r;
+    auto h = r.get_future().then(thrower).then([](int v) { return v + 1; });
+    r.set_value(1);
+    assert(broken(std::move(h)));
+}
+
+static void test_then_chains()
+{
+    gb::promise<int, int> p;
+    auto g = p.get_future().then([](int v) { return v * 2; });
+    p.set_value(21);
+    auto r = std::move(g).get();
+    assert(r && *r == 42);
+}
+
+int main()
+{
+    test_throwing_then_breaks_next();
+    test_then_chains();
+}
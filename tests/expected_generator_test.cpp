@@ -0,0 +1,140 @@
+#undef NDEBUG
+#include <cassert>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "expected_generator.h"
+
+using result = gb::expected<int, std::string>;
+
+static_assert(std::ranges::input_range<gb::generator<result>>);
+static_assert(std::ranges::view<gb::generator<result>>);
+
+// yields 0..n-1 with every every-th element an error; counts how far the producer got
+static gb::generator<result> numbers(int n, int every, int &produced)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        produced = i + 1;
+        if (every && i % every == every - 1)
+        {
+            co_yield gb::unexpected<std::string>("e" + std::to_string(i));
+        }
+        else
+        {
+            co_yield i;
+        }
+    }
+}
+
+static std::vector<std::string> drain(gb::generator<result> &g)
+{
+    std::vector<std::string> out;
+    for (auto &r : g)
+    {
+        out.push_back(r ? std::to_string(*r) : r.error());
+    }
+    return out;
+}
+
+static void test_yield_errors()
+{
+    int produced = 0;
+    auto g = numbers(6, 3, produced);
+    assert(produced == 0); // nothing runs before begin()
+    assert((drain(g) == std::vector<std::string>{"0", "1", "e2", "3", "4", "e5"}));
+    assert(produced == 6 && g.skipped() == 0);
+}
+
+// the first error is yielded and ends the stream; the producer is not resumed after it
+static void test_stop_on_error()
+{
+    int produced = 0;
+    auto g = numbers(10, 3, produced).stop_on_error();
+    assert((drain(g) == std::vector<std::string>{"0", "1", "e2"}));
+    assert(produced == 3);
+
+    // without an error it runs to the end
+    auto all = numbers(4, 0, produced).stop_on_error();
+    assert((drain(all) == std::vector<std::string>{"0", "1", "2", "3"}));
+    assert(produced == 4);
+
+    // an error first
+    auto first = numbers(4, 1, produced).stop_on_error();
+    assert((drain(first) == std::vector<std::string>{"e0"}));
+    assert(produced == 1);
+}
+
+// errors are counted and dropped, and the producer carries on past them
+static void test_skip_errors()
+{
+    int produced = 0;
+    auto g = numbers(10, 3, produced).skip_errors();
+    assert((drain(g) == std::vector<std::string>{"0", "1", "3", "4", "6", "7", "9"}));
+    assert(produced == 10 && g.skipped() == 3);
+
+    // only errors: an empty stream
+    auto none = numbers(5, 1, produced).skip_errors();
+    assert(drain(none).empty() && none.skipped() == 5 && produced == 5);
+}
+
+// an lvalue is handed out in place, everything else shares one slot
+static gb::generator<result> refill(std::vector<const result *> &addresses)
+{
+    result r(std::in_place, 1);
+    co_yield r;
+    addresses.push_back(&r);
+    r = gb::unexpected<std::string>("bad");
+    co_yield r;
+    co_yield 2;
+    co_yield result(std::in_place, 3);
+}
+
+static void test_yield_in_place()
+{
+    std::vector<const result *> addresses;
+    auto g = refill(addresses);
+    std::vector<const result *> seen;
+    for (auto &r : g)
+    {
+        seen.push_back(&r);
+    }
+    assert(seen.size() == 4);
+    assert(seen[0] == seen[1] && seen[0] == addresses[0]);
+    assert(seen[2] == seen[3] && seen[2] != seen[0]);
+}
+
+static gb::generator<result> throwing()
+{
+    co_yield 1;
+    throw std::runtime_error("producer failed");
+}
+
+// an exception in the producer reaches the consumer at the increment that resumed it
+static void test_exception()
+{
+    auto g = throwing();
+    auto it = g.begin();
+    assert(**it == 1);
+    bool caught = false;
+    try
+    {
+        ++it;
+    }
+    catch (const std::runtime_error &)
+    {
+        caught = true;
+    }
+    assert(caught);
+}
+
+int main()
+{
+    test_yield_errors();
+    test_stop_on_error();
+    test_skip_errors();
+    test_yield_in_place();
+    test_exception();
+}
@@ -0,0 +1,116 @@
+#undef NDEBUG
+#include <cassert>
+#include <cstdint>
+
+#include "expected.h"
+
+struct opaque;
+struct declared;
+template <> inline constexpr bool gb::niche_pointee<declared> = true;
+
+// whether T is complete does not change the layout of expected<T*, E>
+constexpr std::size_t opaque_size_before = sizeof(gb::expected<opaque *, int>);
+struct opaque
+{
+    std::uint64_t x;
+};
+static_assert(sizeof(gb::expected<opaque *, int>) == opaque_size_before);
+static_assert(sizeof(gb::expected<opaque *, int>) > sizeof(opaque *), "classes are packed only when they opt in");
+
+struct declared
+{
+    std::uint64_t x;
+};
+static_assert(sizeof(gb::expected<declared *, int>) == sizeof(declared *));
+
+// scalar pointees need no opt-in, unless they may be odd
+static_assert(sizeof(gb::expected<int *, short>) == sizeof(int *));
+static_assert(sizeof(gb::expected<char *, short>) > sizeof(char *));
+
+// expected<T *, void>: the empty state is the tagged word
+static_assert(sizeof(gb::expected<declared *, void>) == sizeof(declared *));
+
+static void test_value_void_niche()
+{
+    declared d{42};
+    gb::expected<declared *, void> ok(&d);
+    assert(ok && ok.value() == &d && (*ok)->x == 42);
+
+    gb::expected<declared *, void> empty(gb::unexpect);
+    assert(!empty && !empty.has_value());
+
+    auto x = ok.transform([](declared *p) { return p->x; });
+    static_assert(std::is_same_v<decltype(x), gb::expected<std::uint64_t, void>>);
+    assert(x && *x == 42);
+    assert(!empty.transform([](declared *p) { return p->x; }));
+
+    auto refilled = empty.or_else([&] { return gb::expected<declared *, void>(&d); });
+    assert(refilled && *refilled == &d);
+    auto dropped = ok.and_then([](declared *) { return gb::expected<declared *, void>(gb::unexpect); });
+    assert(!dropped);
+
+    // a null pointer is a value, not the empty state
+    gb::expected<declared *, void> null(nullptr);
+    assert(null && *null == nullptr);
+}
+
+// expected<void, E *>: the value state is the tagged word
+static_assert(sizeof(gb::expected<void, declared *>) == sizeof(declared *));
+
+static void test_void_error_niche()
+{
+    gb::expected<void, declared *> ok;
+    assert(ok && ok.has_value());
+    ok.value();
+
+    declared d{7};
+    gb::expected<void, declared *> failed(gb::unexpect, &d);
+    assert(!failed && failed.error() == &d && failed.error()->x == 7);
+
+    // a null error is still an error
+    gb::expected<void, declared *> null(gb::unexpect, nullptr);
+    assert(!null && null.error() == nullptr);
+
+    auto code = failed.transform_error([](declared *p) { return static_cast<int>(p->x); });
+    static_assert(std::is_same_v<decltype(code), gb::expected<void, int>>);
+    assert(!code && code.error() == 7);
+
+    int calls = 0;
+    auto next = ok.and_then([&] {
+        ++calls;
+        return gb::expected<void, declared *>(gb::unexpect, &d);
+    });
+    assert(calls == 1 && !next && next.error() == &d);
+    auto recovered = failed.or_else([](declared *) { return gb::expected<void, declared *>(); });
+    assert(recovered);
+
+    failed = gb::unexpected<declared *>(nullptr);
+    assert(!failed && failed.error() == nullptr);
+}
+
+static void test_value_error_niche()
+{
+    declared d{42};
+    gb::expected<declared *, int> ok(&d);
+    assert(ok && (*ok)->x == 42);
+
+    gb::expected<declared *, int> failed(gb::unexpect, 7);
+    assert(!failed && failed.error() == 7);
+
+    // a packed error is handed out by value: callbacks take it by value, const & or &&, and it is
+    // changed by assigning an unexpected
+    static_assert(std::is_same_v<decltype(failed.error()), int>);
+    auto doubled = failed.transform_error([](const int &e) { return 2 * e; });
+    assert(doubled.error() == 14);
+    auto recovered = failed.or_else([](int &&e) { return gb::expected<declared *, int>(gb::unexpect, e + 1); });
+    assert(recovered.error() == 8);
+    failed = gb::unexpected<int>(9);
+    assert(std::move(failed).error() == 9);
+}
+
+int main()
+{
+    test_value_error_niche();
+    test_value_void_niche();
+    test_void_error_niche();
+}
@@ -0,0 +1,109 @@
+#undef NDEBUG
+#include <atomic>
+#include <cassert>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "expected_parallel.h"
+
+// a throwing participant cancels the others and the exception reaches the caller only after every
+// participant has left the job
+static void test_pool_rethrows_after_join()
+{
+    gb::detail::__fork_join_pool pool(4);
+    for (unsigned thrower = 0; thrower < 4; ++thrower)
+    {
+        std::atomic<int> inside{0};
+        std::atomic<int> left{0};
+        auto job = [&](unsigned participant) {
+            ++inside;
+            if (participant == thrower)
+            {
+                --inside;
+                ++left;
+                throw std::runtime_error("boom");
+            }
+            while (!pool.cancelled())
+            {
+            }
+            --inside;
+            ++left;
+        };
+        bool threw = false;
+        try
+        {
+            pool.run(4, job);
+        }
+        catch (const std::runtime_error &)
+        {
+            threw = true;
+        }
+        assert(threw && inside == 0 && left == 4);
+    }
+
+    // the pool is usable afterwards
+    std::atomic<int> ran{0};
+    auto job = [&](unsigned) { ++ran; };
+    pool.run(4, job);
+    assert(ran == 4 && !pool.cancelled());
+}
+
+static void test_value_in_f_throws_to_caller()
+{
+    std::vector<gb::expected<int, int>> in(5000, gb::expected<int, int>(1));
+    bool threw = false;
+    try
+    {
+        (void)gb::parallel_transform(gb::execution::par, std::span(in), [](int x) {
+            gb::expected<int, int> e(gb::unexpect, x);
+            return e.value();
+        });
+    }
+    catch (const gb::bad_expect_access<int> &)
+    {
+        threw = true;
+    }
+    assert(threw);
+}
+
+static void test_short_output_is_rejected()
+{
+    std::vector<int> in(100);
+    std::iota(in.begin(), in.end(), 0);
+    auto twice = [](int x) { return gb::expected<int, int>(2 * x); };
+
+    std::vector<int> out(50, -1);
+    for (int sequenced = 0; sequenced < 2; ++sequenced)
+    {
+        bool threw = false;
+        try
+        {
+            if (sequenced)
+            {
+                (void)gb::parallel_transform(gb::execution::seq, in, std::span(out), twice);
+            }
+            else
+            {
+                (void)gb::parallel_transform(gb::execution::par, in, std::span(out), twice);
+            }
+        }
+        catch (const std::length_error &)
+        {
+            threw = true;
+        }
+        assert(threw && out[0] == -1);
+    }
+
+    out.resize(100);
+    auto done = gb::parallel_transform(gb::execution::par, in, std::span(out), twice);
+    assert(done && out[99] == 198);
+}
+
+int main()
+{
+    test_pool_rethrows_after_join();
+    test_value_in_f_throws_to_caller();
+    test_short_output_is_rejected();
+}
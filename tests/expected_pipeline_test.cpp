@@ -0,0 +1,79 @@
+#undef NDEBUG
+#include <cassert>
+#include <string>
+
+#include "expected.h"
+#include "expected_pipeline.h"
+
+using number = gb::expected<int, std::string>;
+
+// an lvalue source is read, not moved from
+static void test_lvalue_source()
+{
+    number a(std::in_place, 2);
+    gb::expected<std::string, std::string> r = a | gb::map([](int v) { return v * 3; }) |
+                                               gb::then([](int v) { return number(std::in_place, v + 1); }) |
+                                               gb::map([](int v) { return std::to_string(v); });
+    assert(r && *r == "7");
+    assert(*a == 2);
+}
+
+// an error skips value stages and reaches every on_error stage in order
+static void test_error_path()
+{
+    int seen = 0;
+    number r = number(gb::unexpect, "bad") | gb::map([](int v) { return v; }) |
+               gb::on_error([&](const std::string &) { ++seen; }) |
+               gb::on_error([](std::string e) { return number(std::in_place, static_cast<int>(e.size())); }) |
+               gb::map([](int v) { return v * 10; });
+    assert(r && *r == 30);
+    assert(seen == 1);
+
+    number f = number(std::in_place, 1) | gb::then([](int) { return number(gb::unexpect, "e"); }) |
+               gb::map([](int v) { return v + 1; });
+    assert(!f && f.error() == "e");
+}
+
+static void test_void_values()
+{
+    gb::expected<void, std::string> v = number(std::in_place, 1) | gb::map([](int) {});
+    assert(v);
+
+    number r = gb::expected<void, std::string>(gb::expect) | gb::map([] { return 5; });
+    assert(r && *r == 5);
+}
+
+// building the pipeline moves nothing: the value moves as often as in the eager chain
+static int moves = 0;
+
+struct counted
+{
+    explicit counted(int v) : v(v) {}
+    counted(counted &&o) noexcept : v(o.v) { ++moves; }
+    int v;
+};
+
+static void test_moves_match_eager_chain()
+{
+    using box = gb::expected<counted, int>;
+    auto step = [](counted c) { return box(std::in_place, std::move(c)); };
+
+    box a(std::in_place, 1);
+    moves = 0;
+    auto eager = std::move(a).and_then(step).and_then(step).and_then(step);
+    const int eager_moves = moves;
+
+    box b(std::in_place, 1);
+    moves = 0;
+    box fused = std::move(b) | gb::then(step) | gb::then(step) | gb::then(step);
+    assert(moves == eager_moves);
+    assert(eager->v == 1 && fused->v == 1);
+}
+
+int main()
+{
+    test_lvalue_source();
+    test_error_path();
+    test_void_values();
+    test_moves_match_eager_chain();
+}
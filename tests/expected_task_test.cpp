@@ -0,0 +1,107 @@
+#undef NDEBUG
+#include <cassert>
+#include <stdexcept>
+
+#include "expected_task.h"
+
+// symmetric transfer only keeps the descent flat where it is a tail call (see expected_task.h)
+#if defined(__OPTIMIZE__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+static constexpr int deep = 100000;
+#else
+static constexpr int deep = 1000;
+#endif
+
+static gb::task<int, int> chain(int n)
+{
+    if (n == 0)
+    {
+        co_return gb::unexpected<int>(7);
+    }
+    int v = co_await chain(n - 1);
+    co_return v + 1; // never reached: the error finishes every level
+}
+
+static gb::task<int, int> count(int n)
+{
+    if (n == 0)
+    {
+        co_return 0;
+    }
+    co_return co_await count(n - 1) + 1;
+}
+
+// an error finishes a deep chain of awaiting tasks in a loop
+static void test_deep_error_chain()
+{
+    auto r = gb::sync_wait(chain(deep));
+    assert(!r && r.error() == 7);
+
+    auto v = gb::sync_wait(count(deep));
+    assert(v && *v == deep);
+}
+
+static gb::task<int, int> value_of_error()
+{
+    gb::expected<int, int> e(gb::unexpect, 3);
+    co_return e.value(); // throws bad_expect_access<int>
+}
+
+static gb::task<int, int> catches()
+{
+    try
+    {
+        co_return co_await value_of_error();
+    }
+    catch (const gb::bad_expect_access<int> &x)
+    {
+        co_return x.error() + 10;
+    }
+}
+
+static gb::task<int, int> rethrows()
+{
+    co_return co_await value_of_error() + 1;
+}
+
+// an exception leaves a task through its awaiter and sync_wait instead of terminating
+static void test_exception_reaches_awaiter()
+{
+    auto r = gb::sync_wait(catches());
+    assert(r && *r == 13);
+
+    bool threw = false;
+    try
+    {
+        (void)gb::sync_wait(rethrows());
+    }
+    catch (const gb::bad_expect_access<int> &x)
+    {
+        threw = x.error() == 3;
+    }
+    assert(threw);
+}
+
+// a spawned task that throws breaks its future
+static void test_spawned_exception_breaks_future()
+{
+    gb::task_pool pool(2);
+    auto f = gb::spawn(pool, rethrows());
+    f.wait();
+    bool failed = false;
+    try
+    {
+        (void)std::move(f).get();
+    }
+    catch (const std::exception &)
+    {
+        failed = true;
+    }
+    assert(failed);
+}
+
+int main()
+{
+    test_deep_error_chain();
+    test_exception_reaches_awaiter();
+    test_spawned_exception_breaks_future();
+}
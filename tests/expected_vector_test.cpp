@@ -0,0 +1,129 @@
+#undef NDEBUG
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "expected_vector.h"
+
+using result = gb::expected<int, std::string>;
+using batch = gb::expected_vector<int, std::string>;
+
+static batch make(int n, int every)
+{
+    batch b;
+    for (int i = 0; i < n; ++i)
+    {
+        if (i % every == 0)
+        {
+            b.emplace_back(gb::unexpect, "e" + std::to_string(i));
+        }
+        else
+        {
+            b.emplace_back(i);
+        }
+    }
+    return b;
+}
+
+// the error table stays sorted by index and the mask follows the element
+static void test_proxy_assignment()
+{
+    batch b = make(10, 3); // errors at 0, 3, 6, 9
+    assert(b.count_ok() == 6 && b.count_error() == 4);
+
+    b[4] = result(gb::unexpect, "four");
+    assert(!b[4] && b[4].error() == "four");
+    assert(b.count_ok() == 5 && b.errors().size() == 5);
+    assert(b.errors()[2].index == 4 && b.errors()[3].index == 6);
+
+    b[4] = result(std::in_place, 44);
+    assert(b[4] && *b[4] == 44);
+    assert(b.count_ok() == 6 && b.errors().size() == 4);
+
+    // error to error replaces it in place, ok to ok writes the value column
+    b[3] = result(gb::unexpect, "three");
+    assert(b[3].error() == "three" && b.count_error() == 4);
+    b[1] = result(std::in_place, 11);
+    assert(b.values()[1] == 11);
+
+    // a failed slot holds a value initialized placeholder
+    b[2] = result(gb::unexpect, "two");
+    assert(b.values()[2] == 0);
+
+    b[0] = b[1];
+    assert(b[0] == result(std::in_place, 11));
+}
+
+static void test_errors_in_index_order()
+{
+    batch b = make(100, 7);
+    assert(b.count_error() == 15 && b.count_ok() == 85);
+    std::size_t previous = 0;
+    for (std::size_t k = 0; k < b.errors().size(); ++k)
+    {
+        const auto &e = b.errors()[k];
+        assert(k == 0 || e.index > previous);
+        assert(e.index % 7 == 0 && e.error == "e" + std::to_string(e.index));
+        previous = e.index;
+    }
+}
+
+// the mask is one bit per element, with the bits past size() clear
+static void test_ok_mask()
+{
+    batch b = make(70, 2); // odd indices succeed
+    std::span<const std::uint64_t> mask = b.ok_mask();
+    assert(mask.size() == 2);
+    assert(mask[0] == 0xAAAAAAAAAAAAAAAAull);
+    assert(mask[1] == 0x2Aull); // 65, 67, 69
+    std::size_t bits = 0;
+    for (auto w : mask)
+    {
+        bits += static_cast<std::size_t>(std::popcount(w));
+    }
+    assert(bits == b.count_ok());
+}
+
+static void test_pop_back()
+{
+    batch b = make(5, 2); // errors at 0, 2, 4
+    b.pop_back();
+    assert(b.size() == 4 && b.count_error() == 2 && b.errors().back().index == 2);
+    b.pop_back();
+    assert(b.size() == 3 && b.count_error() == 2 && b.count_ok() == 1);
+    b.pop_back();
+    b.pop_back();
+    b.pop_back();
+    assert(b.empty() && b.count_ok() == 0 && b.errors().empty() && b.ok_mask().empty());
+
+    b.emplace_back(1);
+    b.emplace_back(gb::unexpect, "x");
+    assert(b.size() == 2 && !b[1] && b[1].error() == "x" && b.ok_mask()[0] == 1);
+}
+
+static void test_round_trip()
+{
+    std::vector<result> in;
+    for (int i = 0; i < 20; ++i)
+    {
+        in.push_back(i % 5 ? result(std::in_place, i) : result(gb::unexpect, std::to_string(i)));
+    }
+    batch b(in);
+    assert(b.size() == in.size());
+    for (std::size_t i = 0; i < in.size(); ++i)
+    {
+        assert(b[i] == in[i]);
+        assert(static_cast<result>(b[i]) == in[i]);
+    }
+}
+
+int main()
+{
+    test_proxy_assignment();
+    test_errors_in_index_order();
+    test_ok_mask();
+    test_pop_back();
+    test_round_trip();
+}
@@ -0,0 +1,141 @@
+#undef NDEBUG
+#include <cassert>
+#include <ranges>
+#include <string>
+#include <vector>
+
+#include "expected_vector.h"
+#include "expected_views.h"
+
+using result = gb::expected<int, std::string>;
+
+static std::vector<result> sample()
+{
+    return {result(std::in_place, 1), result(gb::unexpect, "a"), result(std::in_place, 2), result(gb::unexpect, "b"),
+            result(std::in_place, 3)};
+}
+
+// over stored elements the selecting views refer to them and keep the range's strength
+static void test_concepts_over_references()
+{
+    auto in = sample();
+    using values_t = decltype(in | gb::views::values);
+    using errors_t = decltype(in | gb::views::errors);
+    using until_t = decltype(in | gb::views::take_while_ok);
+
+    static_assert(std::ranges::view<values_t> && std::ranges::forward_range<values_t>);
+    static_assert(std::ranges::common_range<values_t> && !std::ranges::bidirectional_range<values_t>);
+    static_assert(std::ranges::forward_range<errors_t> && std::ranges::common_range<errors_t>);
+    static_assert(std::ranges::forward_range<until_t> && !std::ranges::common_range<until_t>);
+    static_assert(std::is_same_v<std::ranges::range_reference_t<values_t>, int &>);
+    static_assert(std::is_same_v<std::ranges::range_reference_t<errors_t>, std::string &>);
+
+    // values can be written through
+    for (int &v : in | gb::views::values)
+    {
+        v *= 10;
+    }
+    assert(*in[0] == 10 && *in[4] == 30);
+}
+
+// elements produced on the fly are kept in the iterator: input ranges, f runs once per element
+static void test_produced_elements_are_cached()
+{
+    auto in = sample();
+    int calls = 0;
+    auto doubled = in | gb::views::and_then([&](int v) {
+                       ++calls;
+                       return result(std::in_place, 2 * v);
+                   });
+    using values_t = decltype(doubled | gb::views::values);
+    static_assert(std::ranges::input_range<values_t> && !std::ranges::forward_range<values_t>);
+    static_assert(std::is_same_v<std::ranges::range_value_t<values_t>, int>);
+
+    std::vector<int> out;
+    for (int v : doubled | gb::views::values)
+    {
+        out.push_back(v);
+    }
+    assert((out == std::vector<int>{2, 4, 6}));
+    assert(calls == 3);
+
+    // a second pass produces them again, still once each
+    calls = 0;
+    std::vector<std::string> errs;
+    for (const std::string &e : doubled | gb::views::errors)
+    {
+        errs.push_back(e);
+    }
+    assert((errs == std::vector<std::string>{"a", "b"}));
+    assert(calls == 3);
+}
+
+static void test_take_while_ok()
+{
+    auto in = sample();
+    std::vector<int> out;
+    for (int v : in | gb::views::take_while_ok)
+    {
+        out.push_back(v);
+    }
+    assert((out == std::vector<int>{1}));
+
+    std::vector<result> all_ok{result(std::in_place, 4), result(std::in_place, 5)};
+    auto r = all_ok | gb::views::take_while_ok;
+    assert(std::ranges::distance(r) == 2);
+
+    std::vector<result> none;
+    assert(std::ranges::empty(none | gb::views::take_while_ok));
+}
+
+// transform_ok maps values, leaves errors, and pipes into the standard adaptors
+static void test_transform_ok_and_composition()
+{
+    auto in = sample();
+    auto text = in | gb::views::transform_ok([](int v) { return std::to_string(v); });
+    static_assert(std::is_same_v<std::ranges::range_value_t<decltype(text)>, gb::expected<std::string, std::string>>);
+
+    std::vector<std::string> out;
+    for (auto &&s : text | gb::views::values | std::views::take(2))
+    {
+        out.push_back(s);
+    }
+    assert((out == std::vector<std::string>{"1", "2"}));
+
+    auto failed = in | gb::views::transform_ok([](int v) { return v; }) | gb::views::errors;
+    assert(std::ranges::distance(failed) == 2);
+
+    auto chained = in | std::views::reverse | gb::views::and_then([](int v) {
+                       return v > 1 ? result(std::in_place, v) : result(gb::unexpect, "small");
+                   }) | gb::views::errors;
+    std::vector<std::string> errs;
+    for (std::string e : chained)
+    {
+        errs.push_back(std::move(e));
+    }
+    assert((errs == std::vector<std::string>{"b", "a", "small"}));
+}
+
+// proxy elements convert to the range's value type and are cached like produced elements
+static void test_over_expected_vector()
+{
+    gb::expected_vector<int, std::string> batch(sample());
+    std::vector<int> out;
+    for (int v : batch | gb::views::values)
+    {
+        out.push_back(v);
+    }
+    assert((out == std::vector<int>{1, 2, 3}));
+
+    auto errs = batch | gb::views::errors;
+    assert(std::ranges::distance(errs) == 2);
+}
+
+int main()
+{
+    test_concepts_over_references();
+    test_produced_elements_are_cached();
+    test_take_while_ok();
+    test_transform_ok_and_composition();
+    test_over_expected_vector();
+}
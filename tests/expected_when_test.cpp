@@ -0,0 +1,71 @@
+#undef NDEBUG
+#include <cassert>
+#include <optional>
+#include <vector>
+
+#include "expected_when.h"
+
+static bool broken(auto f)
+{
+    try
+    {
+        (void)std::move(f).get();
+    }
+    catch (const gb::bad_expect_access<void> &)
+    {
+        return true;
+    }
+    return false;
+}
+
+// a broken input completes when_all at once, while the other inputs are still pending
+static void test_broken_input_completes_when_all()
+{
+    std::vector<gb::promise<int, int>> ps(3);
+    std::vector<gb::future<int, int>> fs;
+    for (auto &p : ps)
+    {
+        fs.push_back(p.get_future());
+    }
+    auto all = gb::when_all(std::move(fs));
+    ps[0].set_value(1);
+    {
+        auto dropped = std::move(ps[1]);
+    }
+    assert(all.is_ready());
+    ps[2].set_error(5); // too late, discarded
+    assert(broken(std::move(all)));
+
+    std::optional<gb::promise<int, int>> a(std::in_place);
+    gb::promise<void, int> b;
+    auto tuple = gb::when_all(a->get_future(), b.get_future());
+    a.reset();
+    assert(tuple.is_ready());
+    b.set_value();
+    assert(broken(std::move(tuple)));
+}
+
+// an error that arrives first still wins over a later break
+static void test_first_error_wins()
+{
+    std::vector<gb::promise<int, int>> ps(2);
+    std::vector<gb::future<int, int>> fs;
+    for (auto &p : ps)
+    {
+        fs.push_back(p.get_future());
+    }
+    auto all = gb::when_all(std::move(fs));
+    ps[0].set_error(7);
+    assert(all.is_ready());
+    {
+        auto dropped = std::move(ps[1]);
+    }
+    auto r = std::move(all).get();
+    assert(!r && r.error() == 7);
+}
+
+int main()
+{
+    test_broken_input_completes_when_all();
+    test_first_error_wins();
+}
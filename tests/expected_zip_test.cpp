@@ -0,0 +1,74 @@
+#undef NDEBUG
+#include <cassert>
+#include <string>
+#include <type_traits>
+
+#include "expected_zip.h"
+
+using number = gb::expected<int, std::string>;
+
+static void test_values_reach_f()
+{
+    auto r = gb::zip(number(std::in_place, 2), number(std::in_place, 3), gb::expected<void, std::string>())
+                 .transform([](int a, int b) { return a * b; });
+    static_assert(std::is_same_v<decltype(r), gb::expected<int, std::string>>);
+    assert(r && *r == 6);
+
+    auto v = gb::zip(number(std::in_place, 1)).transform([](int) {});
+    static_assert(std::is_same_v<decltype(v), gb::expected<void, std::string>>);
+    assert(v);
+}
+
+// the result carries the error of the first input that failed, and f is not called
+static void test_first_error_wins()
+{
+    int calls = 0;
+    auto r = gb::zip(number(std::in_place, 1), number(gb::unexpect, "second"), number(gb::unexpect, "third"))
+                 .transform([&](int, int, int) { return ++calls; });
+    assert(!r && r.error() == "second" && calls == 0);
+
+    auto a = gb::zip(number(gb::unexpect, "first"), number(std::in_place, 2)).and_then([](int a, int b) {
+        return number(std::in_place, a + b);
+    });
+    assert(!a && a.error() == "first");
+
+    auto b = gb::zip(number(std::in_place, 1), number(std::in_place, 2)).and_then([](int x, int y) {
+        return number(gb::unexpect, std::to_string(x + y));
+    });
+    assert(!b && b.error() == "3");
+}
+
+// a reference returned by f is copied into the result, not stored as a reference
+static void test_reference_result_is_copied()
+{
+    std::string names[] = {"zero", "one", "two"};
+    gb::expected<int, int> index(std::in_place, 1);
+    auto r = gb::zip(index).transform([&](int i) -> std::string & { return names[i]; });
+    static_assert(std::is_same_v<decltype(r), gb::expected<std::string, int>>);
+    assert(r && *r == "one");
+    names[1] = "changed";
+    assert(*r == "one");
+
+    const int limit = 10;
+    auto c = gb::zip(index).transform([&](int) -> const int & { return limit; });
+    static_assert(std::is_same_v<decltype(c), gb::expected<int, int>>);
+    assert(*c == 10);
+}
+
+// lvalue inputs are read, rvalue inputs give up their values
+static void test_lvalue_and_rvalue_inputs()
+{
+    gb::expected<std::string, int> kept(std::in_place, "kept");
+    gb::expected<std::string, int> taken(std::in_place, std::string(64, 't'));
+    auto r = gb::zip(kept, std::move(taken)).transform([](const std::string &a, std::string b) { return a + b; });
+    assert(r && r->size() == 68);
+    assert(*kept == "kept");
+}
+
+int main()
+{
+    test_values_reach_f();
+    test_first_error_wins();
+    test_reference_result_is_copied();
+    test_lvalue_and_rvalue_inputs();
+}
@@ -0,0 +1,61 @@
+#undef NDEBUG
+#include <cassert>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "expected_future.h"
+#include "expected_parallel.h"
+#include "expected_task.h"
+
+// built with -fno-exceptions: the headers must compile and run without try/catch
+
+static void test_parallel_transform()
+{
+    gb::detail::__fork_join_pool pool(4);
+    std::vector<int> in(1000, 1);
+    std::vector<int> out(1000);
+    std::vector<int> seen(4);
+    auto job = [&](unsigned participant) { seen[participant] = 1; };
+    pool.run(4, job);
+    assert(seen[0] == 1);
+    auto r = gb::parallel_transform(gb::execution::par, in, std::span(out),
+                                    [](int v) { return gb::expected<int, int>(std::in_place, v + 1); });
+    assert(r && out[999] == 2);
+}
+
+static void test_future_then()
+{
+    gb::promise<int, int> p;
+    auto g = p.get_future().then([](int v) { return v * 2; });
+    std::thread producer([&] { p.set_value(21); });
+    producer.join();
+    auto r = std::move(g).get();
+    assert(r && *r == 42);
+}
+
+static gb::task<int, int> add(int n)
+{
+    if (n == 0)
+    {
+        co_return 0;
+    }
+    co_return co_await add(n - 1) + 1;
+}
+
+static void test_tasks()
+{
+    auto r = gb::sync_wait(add(100));
+    assert(r && *r == 100);
+
+    gb::task_pool pool(2);
+    auto s = gb::spawn(pool, add(10)).get();
+    assert(s && *s == 10);
+}
+
+int main()
+{
+    test_parallel_transform();
+    test_future_then();
+    test_tasks();
+}
@@ -0,0 +1,158 @@
+#undef NDEBUG
+#include <cassert>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "expected.h"
+#include "result_vector.h"
+
+// a move-only type that is not trivially relocatable and counts the live objects
+struct tracked
+{
+    static inline int live = 0;
+
+    explicit tracked(int v)
+        : value(v)
+    {
+        ++live;
+    }
+
+    tracked(tracked &&other) noexcept
+        : value(std::exchange(other.value, -1))
+    {
+        ++live;
+    }
+
+    tracked &operator=(tracked &&other) noexcept
+    {
+        value = std::exchange(other.value, -1);
+        return *this;
+    }
+
+    ~tracked() { --live; }
+
+    int value;
+};
+
+using owned = gb::expected<std::unique_ptr<int>, int>;
+using counted = gb::expected<tracked, int>;
+
+static_assert(gb::result_vector<owned>::relocates_trivially);
+static_assert(!gb::result_vector<counted>::relocates_trivially);
+static_assert(!std::is_copy_constructible_v<owned>);
+
+// growing past the inline buffer relocates the elements once, then keeps doubling on the heap
+template <class V, class Make, class Check>
+static void check_growth(Make make, Check check)
+{
+    V v;
+    const auto *buffer = v.data();
+    for (int i = 0; i < 4; ++i)
+    {
+        v.emplace_back(make(i));
+    }
+    assert(v.data() == buffer && v.capacity() == 4);
+
+    v.emplace_back(make(4));
+    assert(v.data() != buffer && v.capacity() == 8 && v.size() == 5);
+    for (int i = 5; i < 20; ++i)
+    {
+        v.emplace_back(make(i));
+    }
+    assert(v.capacity() == 32 && v.size() == 20);
+    for (int i = 0; i < 20; ++i)
+    {
+        check(v[i], i);
+    }
+
+    // erase shifts the rest down in either mode
+    v.erase(v.begin() + 3);
+    assert(v.size() == 19);
+    check(v[2], 2);
+    check(v[3], 4);
+    check(v.back(), 19);
+}
+
+static void test_growth_trivially_relocatable()
+{
+    check_growth<gb::result_vector<owned, 4>>(
+        [](int i) { return i % 3 ? owned(std::make_unique<int>(i)) : owned(gb::unexpect, i); },
+        [](const owned &e, int i) { assert(i % 3 ? e && **e == i : !e && e.error() == i); });
+}
+
+static void test_growth_relocating_by_move()
+{
+    {
+        check_growth<gb::result_vector<counted, 4>>(
+            [](int i) { return i % 3 ? counted(std::in_place, i) : counted(gb::unexpect, i); },
+            [](const counted &e, int i) { assert(i % 3 ? e && e->value == i : !e && e.error() == i); });
+    }
+    assert(tracked::live == 0);
+}
+
+// moving an inline vector relocates its elements, moving a heap one steals the buffer; either
+// way the source is left empty and usable with its inline buffer
+static void test_move()
+{
+    {
+        gb::result_vector<counted, 4> small;
+        small.emplace_back(std::in_place, 1);
+        small.emplace_back(gb::unexpect, 2);
+        const auto *source = small.data();
+
+        auto moved = std::move(small);
+        assert(moved.size() == 2 && moved.data() != source && moved[0]->value == 1 && moved[1].error() == 2);
+        assert(small.empty() && small.data() == source && small.capacity() == 4);
+        assert(tracked::live == 1);
+
+        gb::result_vector<counted, 4> big;
+        for (int i = 0; i < 6; ++i)
+        {
+            big.emplace_back(std::in_place, i);
+        }
+        const auto *heap = big.data();
+        moved = std::move(big);
+        assert(moved.size() == 6 && moved.data() == heap && moved[5]->value == 5);
+        assert(big.empty() && big.capacity() == 4 && tracked::live == 6);
+
+        // the emptied vector grows again
+        for (int i = 0; i < 5; ++i)
+        {
+            big.emplace_back(std::in_place, i);
+        }
+        assert(big.capacity() == 8 && tracked::live == 11);
+
+        // an inline vector moved into one that is on the heap keeps the heap buffer
+        small.emplace_back(std::in_place, 7);
+        big = std::move(small);
+        assert(big.size() == 1 && big.capacity() == 8 && big[0]->value == 7);
+        assert(tracked::live == 7);
+    }
+    assert(tracked::live == 0);
+
+    gb::result_vector<owned, 2> a;
+    a.emplace_back(std::make_unique<int>(1));
+    a.emplace_back(std::make_unique<int>(2));
+    a.emplace_back(std::make_unique<int>(3));
+    gb::result_vector<owned, 2> b = std::move(a);
+    assert(a.empty() && b.size() == 3 && **b[2] == 3);
+}
+
+// an element built from another element of the same vector survives the reallocation it causes
+static void test_emplace_from_self()
+{
+    gb::result_vector<std::string, 2> v;
+    v.emplace_back(40, 'a');
+    v.emplace_back("b");
+    v.push_back(v[0]);
+    assert(v.size() == 3 && v[2] == std::string(40, 'a') && v[0] == v[2]);
+}
+
+int main()
+{
+    test_growth_trivially_relocatable();
+    test_growth_relocating_by_move();
+    test_move();
+    test_emplace_from_self();
+}
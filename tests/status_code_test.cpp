@@ -0,0 +1,169 @@
+#undef NDEBUG
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "expected.h"
+#include "status_code.h"
+
+struct http_domain
+{
+    using value_type = int;
+    static constexpr std::uint64_t id = 0x9b1c54e2d07a3f61;
+    static constexpr const char *name = "http";
+
+    static const char *message(int status) noexcept { return status == 404 ? "not found" : "http status"; }
+    static constexpr bool failure(int status) noexcept { return status >= 400; }
+
+    static constexpr std::errc generic(int status) noexcept
+    {
+        switch (status)
+        {
+        case 403:
+            return std::errc::permission_denied;
+        case 404:
+            return std::errc::no_such_file_or_directory;
+        case 408:
+            return std::errc::timed_out;
+        default:
+            return std::errc();
+        }
+    }
+};
+
+// a value that is not an integer travels through the erased code as its bits
+struct rgba
+{
+    std::uint8_t r, g, b, a;
+};
+
+struct colour_domain
+{
+    using value_type = rgba;
+    static constexpr std::uint64_t id = 0x51f0c3a9e7d28b64;
+    static constexpr const char *name = "colour";
+
+    static const char *message(rgba) noexcept { return "colour"; }
+    static constexpr bool failure(rgba c) noexcept { return c.r != 0; }
+    static constexpr std::errc generic(rgba c) noexcept { return c.r == 0xff ? std::errc::io_error : std::errc(); }
+};
+
+using http_code = gb::status_code<http_domain>;
+using colour_code = gb::status_code<colour_domain>;
+
+#define TEST_ERRORS(X) X(bad_input, "bad input")
+GB_DEFINE_ERROR_DOMAIN(test, 1, TEST_ERRORS);
+
+static_assert(sizeof(gb::erased_status_code) == 16);
+static_assert(http_code(404) == http_code(404) && http_code(404) != http_code(403));
+static_assert(http_code(408) == std::errc::timed_out && http_code(200).success());
+static_assert(gb::posix_code(ENOENT) == std::errc::no_such_file_or_directory);
+
+// codes of different domains are equivalent when both map to the same std::errc, either way round
+static void test_equivalence_across_domains()
+{
+    const gb::erased_status_code posix = gb::posix_code(ENOENT);
+    const gb::erased_status_code generic = gb::generic_code(std::errc::no_such_file_or_directory);
+    const gb::erased_status_code http = http_code(404);
+
+    assert(posix == generic && generic == posix);
+    assert(posix == http && http == posix && generic == http);
+    assert(http_code(408) == gb::erased_status_code(gb::posix_code(ETIMEDOUT)));
+
+    // different errc, or none at all
+    assert(gb::erased_status_code(http_code(403)) != posix);
+    assert(gb::erased_status_code(http_code(500)) != gb::erased_status_code(gb::posix_code(EIO)));
+    assert(gb::erased_status_code(colour_code(rgba{0xff, 0, 0, 0})) == gb::erased_status_code(gb::posix_code(EIO)));
+    assert(gb::erased_status_code(colour_code(rgba{0x10, 0, 0, 0})) != gb::erased_status_code(gb::posix_code(EIO)));
+
+    // catalog errors have no generic equivalent: only equal to themselves
+    const gb::erased_status_code catalog = gb::catalog_code(test::bad_input);
+    assert(catalog == gb::erased_status_code(gb::catalog_code(test::bad_input)));
+    assert(catalog != posix && catalog != gb::erased_status_code(gb::posix_code(1)));
+
+    // successes carry no errc, so only compare equal within a domain
+    assert(gb::erased_status_code() == gb::erased_status_code(gb::generic_code()));
+    assert(gb::erased_status_code(gb::posix_code(0)) != gb::erased_status_code(http_code(200)));
+
+    assert(posix == std::errc::no_such_file_or_directory && http == std::errc::no_such_file_or_directory);
+    assert(!(catalog == std::errc()));
+}
+
+// within a domain the values are compared, even if they map to the same errc
+static void test_same_domain()
+{
+    assert(gb::erased_status_code(http_code(404)) == gb::erased_status_code(http_code(404)));
+    assert(gb::erased_status_code(http_code(500)) != gb::erased_status_code(http_code(501)));
+
+    const gb::erased_status_code a = colour_code(rgba{1, 2, 3, 4});
+    const gb::erased_status_code b = colour_code(rgba{1, 2, 3, 5});
+    assert(a != b && a == gb::erased_status_code(colour_code(rgba{1, 2, 3, 4})));
+
+    // a second table with the same id, as another shared object would have, is the same domain
+    const gb::status_domain copy = http_code::domain();
+    assert(&copy != &http_code::domain() && copy == http_code::domain());
+}
+
+static void test_erased_round_trip()
+{
+    const gb::erased_status_code e = colour_code(rgba{1, 2, 3, 4});
+    assert(e.is<colour_domain>() && !e.is<http_domain>());
+    const rgba c = e.to<colour_domain>().value();
+    assert(c.r == 1 && c.g == 2 && c.b == 3 && c.a == 4);
+    assert(e.failure() && std::strcmp(e.domain().name, "colour") == 0);
+
+    const gb::erased_status_code h = http_code(404);
+    assert(h.to<http_domain>() == http_code(404) && std::strcmp(h.message(), "not found") == 0);
+    assert(gb::erased_status_code().success() && gb::erased_status_code().is<gb::generic_domain>());
+}
+
+// an errno message is a static string: later calls, from any thread, leave it alone
+static void test_errno_messages()
+{
+    const char *enoent = gb::posix_code(ENOENT).message();
+    const std::string text = enoent;
+    assert(!text.empty());
+
+    std::thread other([] {
+        for (int e = 0; e < 300; ++e)
+        {
+            assert(gb::posix_code(e).message() != nullptr);
+        }
+    });
+    other.join();
+    (void)gb::posix_code(EACCES).message();
+
+    assert(gb::posix_code(ENOENT).message() == enoent && text == enoent);
+    assert(gb::generic_code(std::errc::no_such_file_or_directory).message() == enoent);
+    assert(gb::posix_code(-1).message() != nullptr && gb::posix_code(100000).message() != nullptr);
+}
+
+static gb::expected<int, gb::erased_status_code> open_file(bool exists)
+{
+    if (!exists)
+    {
+        return gb::unexpected<gb::erased_status_code>(gb::posix_code(ENOENT));
+    }
+    return 1;
+}
+
+static void test_in_expected()
+{
+    const auto r = open_file(false);
+    assert(!r && r.error() == std::errc::no_such_file_or_directory);
+    assert(r.error() == gb::erased_status_code(http_code(404)));
+    assert(open_file(true).value() == 1);
+}
+
+int main()
+{
+    test_equivalence_across_domains();
+    test_same_domain();
+    test_erased_round_trip();
+    test_errno_messages();
+    test_in_expected();
+}